@@ -0,0 +1,60 @@
+#!/bin/sh
+#
+# Benchmarks the hot token cache. Tokenizes a generated Zipfian corpus with the
+# cache disabled (-c 0) and with the default cache, and prints the best
+# tokenization time of each, the cache hit rate and the speedup. Run through
+# "make bench".
+#
+# Environment:
+#    BUILD_DIR   - Directory holding ch-ir-tokenizer and ch-ir-zipf-gen.
+#                  [Default: .]
+#    CORPUS_DIR  - Corpus directory, generated if it does not exist.
+#                  [Default: bench-corpus]
+#    TABLE_SIZE  - Hashmap table size. [Default: 4096]
+#    RUNS        - Runs of each configuration. [Default: 5]
+#
+
+BUILD_DIR=${BUILD_DIR:-.}
+CORPUS_DIR=${CORPUS_DIR:-bench-corpus}
+TABLE_SIZE=${TABLE_SIZE:-4096}
+RUNS=${RUNS:-5}
+
+if [ ! -d "$CORPUS_DIR" ]; then
+   echo "Generating the Zipfian corpus in $CORPUS_DIR"
+   "$BUILD_DIR/ch-ir-zipf-gen" "$CORPUS_DIR" || exit 1
+fi
+
+# Prints the best tokenization time in ms and the hit rate of $RUNS runs.
+bench_run ()
+{
+   i=0
+   best=
+   hit_rate=-
+   while [ $i -lt "$RUNS" ]; do
+      out=$("$BUILD_DIR/ch-ir-tokenizer" -s -c "$1" "$CORPUS_DIR" \
+         "$TABLE_SIZE") || exit 1
+      ms=$(echo "$out" | sed -n 's/^Time Taken for Tokenization: \([0-9]*\) ms$/\1/p')
+      rate=$(echo "$out" | sed -n 's/^Hot Token Cache Hit Rate: \([0-9.]*%\).*$/\1/p')
+      if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then
+         best=$ms
+      fi
+      if [ -n "$rate" ]; then
+         hit_rate=$rate
+      fi
+      i=$((i + 1))
+   done
+   echo "$best $hit_rate"
+}
+
+set -- $(bench_run 0)
+off_ms=$1
+set -- $(bench_run 1024)
+on_ms=$1
+on_rate=$2
+
+echo "Hot token cache benchmark, best of $RUNS runs on $CORPUS_DIR:"
+printf "| %-10s | %18s | %8s |\n" "Hot Cache" "Tokenization (ms)" "Hit Rate"
+printf "| %-10s | %18s | %8s |\n" "0" "$off_ms" "-"
+printf "| %-10s | %18s | %8s |\n" "1024" "$on_ms" "$on_rate"
+awk -v off="$off_ms" -v on="$on_ms" \
+   'BEGIN { if (on > 0) printf "Speedup: %.2fx\n", off / on }'
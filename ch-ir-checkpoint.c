@@ -0,0 +1,569 @@
+/*******************************************************************************
+ * Copyright (c) 2026, agent <agent@local>
+ *
+ * \file   ch-ir-checkpoint.c
+ *
+ * \author agent
+ *
+ * \date   Oct 18, 2026
+ *
+ * \brief  Checkpoint file reader and writer.
+ *
+ * File Format
+ * ===========
+ * All integers are in host byte order; a checkpoint is meant to be resumed on
+ * the machine which wrote it. The token counts, Num Tokens and the hot cache
+ * counts are 64 bit so that runs of more than 2^32 tokens can be saved; all
+ * the others are 32 bit.
+ *
+ *    "CHIRCKPT" | Version | Root Dir Len | Root Dir |
+ *    Num Tokens | Num Docs | Hot Cache Hits | Hot Cache Lookups |
+ *    Records ... | 'E' | Num Token Records | Num File Records
+ *
+ * Each record starts with a one byte type:
+ *    'T' | Count | Token Len | Token
+ *    'F' | Filename Len | Filename
+ *
+ * The end record lets the reader tell a complete checkpoint from one which
+ * was cut short. Tokens and file names are at most CHECKPOINT_MAX_STRING_LEN
+ * bytes long.
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ch-ir-checkpoint.h"
+
+#define CHECKPOINT_MAGIC               "CHIRCKPT"
+#define CHECKPOINT_MAGIC_LEN           (8)
+#define CHECKPOINT_VERSION             (2)
+#define CHECKPOINT_IO_BUFFER_SIZE      (1024 * 1024)
+#define CHECKPOINT_TMP_SUFFIX          ".tmp"
+#define CHECKPOINT_MAX_STRING_LEN      (16 * 1024 * 1024)
+
+#define CHECKPOINT_RECORD_TOKEN        ('T')
+#define CHECKPOINT_RECORD_FILE         ('F')
+#define CHECKPOINT_RECORD_END          ('E')
+
+typedef struct _CHECKPOINT_WRITER_CTXT_X
+{
+   FILE *p_file;
+
+   char *pc_io_buffer;
+
+   char *pc_path;
+
+   char *pc_tmp_path;
+
+   uint32_t ui_num_token_records;
+
+   uint32_t ui_num_file_records;
+
+   bool b_write_failed;
+} CHECKPOINT_WRITER_CTXT_X;
+
+static void checkpoint_write (
+   CHECKPOINT_WRITER_CTXT_X *px_writer_ctxt,
+   const void *p_data,
+   uint32_t ui_data_len);
+
+static void checkpoint_write_uint (
+   CHECKPOINT_WRITER_CTXT_X *px_writer_ctxt,
+   uint32_t ui_value);
+
+static void checkpoint_write_uint64 (
+   CHECKPOINT_WRITER_CTXT_X *px_writer_ctxt,
+   uint64_t ui64_value);
+
+static bool checkpoint_read_uint (
+   FILE *p_file,
+   uint32_t *pui_value);
+
+static bool checkpoint_read_uint64 (
+   FILE *p_file,
+   uint64_t *pui64_value);
+
+static CHECKPOINT_RET_E checkpoint_read_string (
+   FILE *p_file,
+   off_t x_file_size,
+   char **ppc_buffer,
+   uint32_t *pui_buffer_size,
+   uint32_t *pui_len);
+
+static void checkpoint_write (
+   CHECKPOINT_WRITER_CTXT_X *px_writer_ctxt,
+   const void *p_data,
+   uint32_t ui_data_len)
+{
+   if ((true == px_writer_ctxt->b_write_failed) || (0 == ui_data_len))
+   {
+      goto LBL_CLEANUP;
+   }
+
+   if (1 != fwrite (p_data, ui_data_len, 1, px_writer_ctxt->p_file))
+   {
+      px_writer_ctxt->b_write_failed = true;
+   }
+LBL_CLEANUP:
+   return;
+}
+
+static void checkpoint_write_uint (
+   CHECKPOINT_WRITER_CTXT_X *px_writer_ctxt,
+   uint32_t ui_value)
+{
+   checkpoint_write (px_writer_ctxt, &ui_value, sizeof(ui_value));
+}
+
+static void checkpoint_write_uint64 (
+   CHECKPOINT_WRITER_CTXT_X *px_writer_ctxt,
+   uint64_t ui64_value)
+{
+   checkpoint_write (px_writer_ctxt, &ui64_value, sizeof(ui64_value));
+}
+
+static bool checkpoint_read_uint (
+   FILE *p_file,
+   uint32_t *pui_value)
+{
+   return (1 == fread (pui_value, sizeof(*pui_value), 1, p_file));
+}
+
+static bool checkpoint_read_uint64 (
+   FILE *p_file,
+   uint64_t *pui64_value)
+{
+   return (1 == fread (pui64_value, sizeof(*pui64_value), 1, p_file));
+}
+
+/*
+ * Reads a length prefixed string into *ppc_buffer, growing it as required.
+ * The string is NUL terminated. A length which is larger than
+ * CHECKPOINT_MAX_STRING_LEN or than what is left of the x_file_size bytes of
+ * the file can only come from a corrupt checkpoint.
+ */
+static CHECKPOINT_RET_E checkpoint_read_string (
+   FILE *p_file,
+   off_t x_file_size,
+   char **ppc_buffer,
+   uint32_t *pui_buffer_size,
+   uint32_t *pui_len)
+{
+   CHECKPOINT_RET_E e_checkpoint_ret = eCHECKPOINT_RET_FAILURE;
+   char *pc_new_buffer = NULL;
+   uint32_t ui_len = 0;
+   off_t x_offset = 0;
+
+   if (false == checkpoint_read_uint (p_file, &ui_len))
+   {
+      e_checkpoint_ret = eCHECKPOINT_RET_BAD_FORMAT;
+      goto LBL_CLEANUP;
+   }
+
+   x_offset = ftello (p_file);
+   if ((ui_len > CHECKPOINT_MAX_STRING_LEN) || (-1 == x_offset)
+      || ((off_t) ui_len > (x_file_size - x_offset)))
+   {
+      e_checkpoint_ret = eCHECKPOINT_RET_BAD_FORMAT;
+      goto LBL_CLEANUP;
+   }
+
+   if ((ui_len + 1) > *pui_buffer_size)
+   {
+      pc_new_buffer = pal_malloc (ui_len + 1, NULL);
+      if (NULL == pc_new_buffer)
+      {
+         e_checkpoint_ret = eCHECKPOINT_RET_RESOURCE_FAILURE;
+         goto LBL_CLEANUP;
+      }
+      if (NULL != *ppc_buffer)
+      {
+         pal_free (*ppc_buffer);
+      }
+      *ppc_buffer = pc_new_buffer;
+      *pui_buffer_size = ui_len + 1;
+   }
+
+   if ((ui_len > 0) && (1 != fread (*ppc_buffer, ui_len, 1, p_file)))
+   {
+      e_checkpoint_ret = eCHECKPOINT_RET_BAD_FORMAT;
+      goto LBL_CLEANUP;
+   }
+   (*ppc_buffer)[ui_len] = '\0';
+   *pui_len = ui_len;
+
+   e_checkpoint_ret = eCHECKPOINT_RET_SUCCESS;
+LBL_CLEANUP:
+   return e_checkpoint_ret;
+}
+
+CHECKPOINT_RET_E checkpoint_writer_create (
+   CHECKPOINT_WRITER_HDL *phl_writer_hdl,
+   char *pc_path,
+   CHECKPOINT_HEADER_X *px_header)
+{
+   CHECKPOINT_RET_E e_checkpoint_ret = eCHECKPOINT_RET_FAILURE;
+   CHECKPOINT_WRITER_CTXT_X *px_writer_ctxt = NULL;
+   uint32_t ui_path_len = 0;
+   uint32_t ui_root_len = 0;
+
+   if ((NULL == phl_writer_hdl) || (NULL == pc_path) || (NULL == px_header)
+      || (NULL == px_header->pc_root_dir))
+   {
+      e_checkpoint_ret = eCHECKPOINT_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   px_writer_ctxt = pal_malloc (sizeof(CHECKPOINT_WRITER_CTXT_X), NULL);
+   if (NULL == px_writer_ctxt)
+   {
+      e_checkpoint_ret = eCHECKPOINT_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+   (void) pal_memset (px_writer_ctxt, 0x00, sizeof(*px_writer_ctxt));
+
+   ui_path_len = pal_strlen (pc_path);
+   px_writer_ctxt->pc_path = pal_malloc (ui_path_len + 1, NULL);
+   px_writer_ctxt->pc_tmp_path = pal_malloc (
+      ui_path_len + sizeof(CHECKPOINT_TMP_SUFFIX), NULL);
+   px_writer_ctxt->pc_io_buffer = pal_malloc (CHECKPOINT_IO_BUFFER_SIZE, NULL);
+   if ((NULL == px_writer_ctxt->pc_path) || (NULL == px_writer_ctxt->pc_tmp_path)
+      || (NULL == px_writer_ctxt->pc_io_buffer))
+   {
+      e_checkpoint_ret = eCHECKPOINT_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+   (void) snprintf (px_writer_ctxt->pc_path, ui_path_len + 1, "%s", pc_path);
+   (void) snprintf (px_writer_ctxt->pc_tmp_path,
+      ui_path_len + sizeof(CHECKPOINT_TMP_SUFFIX), "%s%s", pc_path,
+      CHECKPOINT_TMP_SUFFIX);
+
+   px_writer_ctxt->p_file = fopen (px_writer_ctxt->pc_tmp_path, "wb");
+   if (NULL == px_writer_ctxt->p_file)
+   {
+      e_checkpoint_ret = eCHECKPOINT_RET_FAILURE;
+      goto LBL_CLEANUP;
+   }
+   (void) setvbuf (px_writer_ctxt->p_file, px_writer_ctxt->pc_io_buffer,
+      _IOFBF, CHECKPOINT_IO_BUFFER_SIZE);
+
+   ui_root_len = pal_strlen (px_header->pc_root_dir);
+   checkpoint_write (px_writer_ctxt, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_LEN);
+   checkpoint_write_uint (px_writer_ctxt, CHECKPOINT_VERSION);
+   checkpoint_write_uint (px_writer_ctxt, ui_root_len);
+   checkpoint_write (px_writer_ctxt, px_header->pc_root_dir, ui_root_len);
+   checkpoint_write_uint64 (px_writer_ctxt, px_header->ui64_num_tokens);
+   checkpoint_write_uint (px_writer_ctxt, px_header->ui_num_docs);
+   checkpoint_write_uint64 (px_writer_ctxt, px_header->ui64_hot_cache_hits);
+   checkpoint_write_uint64 (px_writer_ctxt, px_header->ui64_hot_cache_lookups);
+
+   *phl_writer_hdl = px_writer_ctxt;
+   px_writer_ctxt = NULL;
+   e_checkpoint_ret = eCHECKPOINT_RET_SUCCESS;
+LBL_CLEANUP:
+   if (NULL != px_writer_ctxt)
+   {
+      (void) checkpoint_writer_delete (px_writer_ctxt, false);
+   }
+   return e_checkpoint_ret;
+}
+
+CHECKPOINT_RET_E checkpoint_writer_add_token (
+   CHECKPOINT_WRITER_HDL hl_writer_hdl,
+   char *pc_token,
+   uint32_t ui_token_len,
+   uint64_t ui64_count)
+{
+   CHECKPOINT_RET_E e_checkpoint_ret = eCHECKPOINT_RET_FAILURE;
+   CHECKPOINT_WRITER_CTXT_X *px_writer_ctxt = NULL;
+   char c_type = CHECKPOINT_RECORD_TOKEN;
+
+   if ((NULL == hl_writer_hdl) || (NULL == pc_token)
+      || (ui_token_len > CHECKPOINT_MAX_STRING_LEN))
+   {
+      e_checkpoint_ret = eCHECKPOINT_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   px_writer_ctxt = (CHECKPOINT_WRITER_CTXT_X *) hl_writer_hdl;
+
+   checkpoint_write (px_writer_ctxt, &c_type, sizeof(c_type));
+   checkpoint_write_uint64 (px_writer_ctxt, ui64_count);
+   checkpoint_write_uint (px_writer_ctxt, ui_token_len);
+   checkpoint_write (px_writer_ctxt, pc_token, ui_token_len);
+   px_writer_ctxt->ui_num_token_records++;
+
+   e_checkpoint_ret = (true == px_writer_ctxt->b_write_failed) ?
+      eCHECKPOINT_RET_FAILURE : eCHECKPOINT_RET_SUCCESS;
+LBL_CLEANUP:
+   return e_checkpoint_ret;
+}
+
+CHECKPOINT_RET_E checkpoint_writer_add_file (
+   CHECKPOINT_WRITER_HDL hl_writer_hdl,
+   char *pc_filename)
+{
+   CHECKPOINT_RET_E e_checkpoint_ret = eCHECKPOINT_RET_FAILURE;
+   CHECKPOINT_WRITER_CTXT_X *px_writer_ctxt = NULL;
+   char c_type = CHECKPOINT_RECORD_FILE;
+   uint32_t ui_filename_len = 0;
+
+   if ((NULL == hl_writer_hdl) || (NULL == pc_filename))
+   {
+      e_checkpoint_ret = eCHECKPOINT_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   px_writer_ctxt = (CHECKPOINT_WRITER_CTXT_X *) hl_writer_hdl;
+
+   ui_filename_len = pal_strlen (pc_filename);
+   if (ui_filename_len > CHECKPOINT_MAX_STRING_LEN)
+   {
+      e_checkpoint_ret = eCHECKPOINT_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+   checkpoint_write (px_writer_ctxt, &c_type, sizeof(c_type));
+   checkpoint_write_uint (px_writer_ctxt, ui_filename_len);
+   checkpoint_write (px_writer_ctxt, pc_filename, ui_filename_len);
+   px_writer_ctxt->ui_num_file_records++;
+
+   e_checkpoint_ret = (true == px_writer_ctxt->b_write_failed) ?
+      eCHECKPOINT_RET_FAILURE : eCHECKPOINT_RET_SUCCESS;
+LBL_CLEANUP:
+   return e_checkpoint_ret;
+}
+
+CHECKPOINT_RET_E checkpoint_writer_delete (
+   CHECKPOINT_WRITER_HDL hl_writer_hdl,
+   bool b_commit)
+{
+   CHECKPOINT_RET_E e_checkpoint_ret = eCHECKPOINT_RET_FAILURE;
+   CHECKPOINT_WRITER_CTXT_X *px_writer_ctxt = NULL;
+   char c_type = CHECKPOINT_RECORD_END;
+
+   if (NULL == hl_writer_hdl)
+   {
+      e_checkpoint_ret = eCHECKPOINT_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   px_writer_ctxt = (CHECKPOINT_WRITER_CTXT_X *) hl_writer_hdl;
+
+   if (NULL != px_writer_ctxt->p_file)
+   {
+      if (true == b_commit)
+      {
+         checkpoint_write (px_writer_ctxt, &c_type, sizeof(c_type));
+         checkpoint_write_uint (px_writer_ctxt,
+            px_writer_ctxt->ui_num_token_records);
+         checkpoint_write_uint (px_writer_ctxt,
+            px_writer_ctxt->ui_num_file_records);
+         if ((0 != fflush (px_writer_ctxt->p_file))
+            || (0 != fsync (fileno (px_writer_ctxt->p_file))))
+         {
+            px_writer_ctxt->b_write_failed = true;
+         }
+      }
+
+      if (0 != fclose (px_writer_ctxt->p_file))
+      {
+         px_writer_ctxt->b_write_failed = true;
+      }
+      px_writer_ctxt->p_file = NULL;
+
+      if ((true == b_commit) && (false == px_writer_ctxt->b_write_failed)
+         && (0 == rename (px_writer_ctxt->pc_tmp_path,
+               px_writer_ctxt->pc_path)))
+      {
+         e_checkpoint_ret = eCHECKPOINT_RET_SUCCESS;
+      }
+      else
+      {
+         (void) unlink (px_writer_ctxt->pc_tmp_path);
+         e_checkpoint_ret = (true == b_commit) ?
+            eCHECKPOINT_RET_FAILURE : eCHECKPOINT_RET_SUCCESS;
+      }
+   }
+
+   if (NULL != px_writer_ctxt->pc_io_buffer)
+   {
+      pal_free (px_writer_ctxt->pc_io_buffer);
+   }
+   if (NULL != px_writer_ctxt->pc_tmp_path)
+   {
+      pal_free (px_writer_ctxt->pc_tmp_path);
+   }
+   if (NULL != px_writer_ctxt->pc_path)
+   {
+      pal_free (px_writer_ctxt->pc_path);
+   }
+   pal_free (px_writer_ctxt);
+LBL_CLEANUP:
+   return e_checkpoint_ret;
+}
+
+CHECKPOINT_RET_E checkpoint_load (
+   char *pc_path,
+   CHECKPOINT_HEADER_X *px_header,
+   pfn_checkpoint_token_cbk fn_token_cbk,
+   pfn_checkpoint_file_cbk fn_file_cbk,
+   void *p_app_data)
+{
+   CHECKPOINT_RET_E e_checkpoint_ret = eCHECKPOINT_RET_FAILURE;
+   FILE *p_file = NULL;
+   char *pc_io_buffer = NULL;
+   char *pc_buffer = NULL;
+   uint32_t ui_buffer_size = 0;
+   char ca_magic[CHECKPOINT_MAGIC_LEN] = {0};
+   struct stat x_stat = {0};
+   char c_type = 0;
+   uint32_t ui_version = 0;
+   uint32_t ui_len = 0;
+   uint64_t ui64_count = 0;
+   uint32_t ui_num_token_records = 0;
+   uint32_t ui_num_file_records = 0;
+   uint32_t ui_expected_token_records = 0;
+   uint32_t ui_expected_file_records = 0;
+
+   if ((NULL == pc_path) || (NULL == px_header) || (NULL == fn_token_cbk)
+      || (NULL == fn_file_cbk))
+   {
+      e_checkpoint_ret = eCHECKPOINT_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+   (void) pal_memset (px_header, 0x00, sizeof(*px_header));
+
+   p_file = fopen (pc_path, "rb");
+   if (NULL == p_file)
+   {
+      e_checkpoint_ret = (ENOENT == errno) ?
+         eCHECKPOINT_RET_FILE_NOT_FOUND : eCHECKPOINT_RET_FAILURE;
+      goto LBL_CLEANUP;
+   }
+   if (0 != fstat (fileno (p_file), &x_stat))
+   {
+      e_checkpoint_ret = eCHECKPOINT_RET_FAILURE;
+      goto LBL_CLEANUP;
+   }
+   pc_io_buffer = pal_malloc (CHECKPOINT_IO_BUFFER_SIZE, NULL);
+   if (NULL != pc_io_buffer)
+   {
+      (void) setvbuf (p_file, pc_io_buffer, _IOFBF, CHECKPOINT_IO_BUFFER_SIZE);
+   }
+
+   if ((1 != fread (ca_magic, sizeof(ca_magic), 1, p_file))
+      || (0 != memcmp (ca_magic, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_LEN))
+      || (false == checkpoint_read_uint (p_file, &ui_version))
+      || (CHECKPOINT_VERSION != ui_version))
+   {
+      e_checkpoint_ret = eCHECKPOINT_RET_BAD_FORMAT;
+      goto LBL_CLEANUP;
+   }
+
+   e_checkpoint_ret = checkpoint_read_string (p_file, x_stat.st_size,
+      &(px_header->pc_root_dir), &ui_buffer_size, &ui_len);
+   ui_buffer_size = 0;
+   if (eCHECKPOINT_RET_SUCCESS != e_checkpoint_ret)
+   {
+      goto LBL_CLEANUP;
+   }
+
+   if ((false == checkpoint_read_uint64 (p_file,
+            &(px_header->ui64_num_tokens)))
+      || (false == checkpoint_read_uint (p_file, &(px_header->ui_num_docs)))
+      || (false == checkpoint_read_uint64 (p_file,
+            &(px_header->ui64_hot_cache_hits)))
+      || (false == checkpoint_read_uint64 (p_file,
+            &(px_header->ui64_hot_cache_lookups))))
+   {
+      e_checkpoint_ret = eCHECKPOINT_RET_BAD_FORMAT;
+      goto LBL_CLEANUP;
+   }
+
+   while (1)
+   {
+      if (1 != fread (&c_type, sizeof(c_type), 1, p_file))
+      {
+         e_checkpoint_ret = eCHECKPOINT_RET_BAD_FORMAT;
+         goto LBL_CLEANUP;
+      }
+
+      if (CHECKPOINT_RECORD_TOKEN == c_type)
+      {
+         if (false == checkpoint_read_uint64 (p_file, &ui64_count))
+         {
+            e_checkpoint_ret = eCHECKPOINT_RET_BAD_FORMAT;
+            goto LBL_CLEANUP;
+         }
+         e_checkpoint_ret = checkpoint_read_string (p_file,
+            x_stat.st_size, &pc_buffer, &ui_buffer_size, &ui_len);
+         if (eCHECKPOINT_RET_SUCCESS != e_checkpoint_ret)
+         {
+            goto LBL_CLEANUP;
+         }
+         e_checkpoint_ret = fn_token_cbk (pc_buffer, ui_len, ui64_count,
+            p_app_data);
+         if (eCHECKPOINT_RET_SUCCESS != e_checkpoint_ret)
+         {
+            goto LBL_CLEANUP;
+         }
+         ui_num_token_records++;
+      }
+      else if (CHECKPOINT_RECORD_FILE == c_type)
+      {
+         e_checkpoint_ret = checkpoint_read_string (p_file,
+            x_stat.st_size, &pc_buffer, &ui_buffer_size, &ui_len);
+         if (eCHECKPOINT_RET_SUCCESS != e_checkpoint_ret)
+         {
+            goto LBL_CLEANUP;
+         }
+         e_checkpoint_ret = fn_file_cbk (pc_buffer, p_app_data);
+         if (eCHECKPOINT_RET_SUCCESS != e_checkpoint_ret)
+         {
+            goto LBL_CLEANUP;
+         }
+         ui_num_file_records++;
+      }
+      else if (CHECKPOINT_RECORD_END == c_type)
+      {
+         break;
+      }
+      else
+      {
+         e_checkpoint_ret = eCHECKPOINT_RET_BAD_FORMAT;
+         goto LBL_CLEANUP;
+      }
+   }
+
+   if ((false == checkpoint_read_uint (p_file, &ui_expected_token_records))
+      || (false == checkpoint_read_uint (p_file, &ui_expected_file_records))
+      || (ui_expected_token_records != ui_num_token_records)
+      || (ui_expected_file_records != ui_num_file_records))
+   {
+      e_checkpoint_ret = eCHECKPOINT_RET_BAD_FORMAT;
+      goto LBL_CLEANUP;
+   }
+
+   e_checkpoint_ret = eCHECKPOINT_RET_SUCCESS;
+LBL_CLEANUP:
+   if (NULL != p_file)
+   {
+      (void) fclose (p_file);
+   }
+   if (NULL != pc_io_buffer)
+   {
+      pal_free (pc_io_buffer);
+   }
+   if (NULL != pc_buffer)
+   {
+      pal_free (pc_buffer);
+   }
+   if ((eCHECKPOINT_RET_SUCCESS != e_checkpoint_ret) && (NULL != px_header)
+      && (NULL != px_header->pc_root_dir))
+   {
+      pal_free (px_header->pc_root_dir);
+      px_header->pc_root_dir = NULL;
+   }
+   return e_checkpoint_ret;
+}
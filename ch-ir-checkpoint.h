@@ -0,0 +1,116 @@
+/*******************************************************************************
+ * Copyright (c) 2026, agent <agent@local>
+ *
+ * \file   ch-ir-checkpoint.h
+ *
+ * \author agent
+ *
+ * \date   Oct 18, 2026
+ *
+ * \brief  Checkpoint file reader and writer. A checkpoint holds the token
+ *         table and the list of files which have been tokenized so that an
+ *         interrupted run can be resumed.
+ *
+ ******************************************************************************/
+
+#ifndef __CH_IR_CHECKPOINT_H__
+#define __CH_IR_CHECKPOINT_H__
+
+#include <ch-pal/exp_pal.h>
+
+/******************************** ENUMERATIONS ********************************/
+typedef enum _CHECKPOINT_RET_E
+{
+   eCHECKPOINT_RET_SUCCESS = 0,
+
+   eCHECKPOINT_RET_FAILURE,
+
+   eCHECKPOINT_RET_INVALID_ARGS,
+
+   eCHECKPOINT_RET_RESOURCE_FAILURE,
+
+   eCHECKPOINT_RET_FILE_NOT_FOUND,
+
+   /*
+    * The file is not a checkpoint, is from an incompatible version or was
+    * truncated.
+    */
+   eCHECKPOINT_RET_BAD_FORMAT
+} CHECKPOINT_RET_E;
+
+/*********************** CLASS/STRUCTURE/UNION DATA TYPES *********************/
+typedef struct _CHECKPOINT_WRITER_CTXT_X *CHECKPOINT_WRITER_HDL;
+
+typedef struct _CHECKPOINT_HEADER_X
+{
+   /*
+    * Directory being tokenized. A checkpoint is only resumed for the same
+    * directory. When reading, the string is allocated by
+    * checkpoint_load and must be released using pal_free.
+    */
+   char *pc_root_dir;
+
+   uint64_t ui64_num_tokens;
+
+   uint32_t ui_num_docs;
+
+   uint64_t ui64_hot_cache_hits;
+
+   uint64_t ui64_hot_cache_lookups;
+} CHECKPOINT_HEADER_X;
+
+/*
+ * pc_token is NUL terminated and is only valid for the duration of the call.
+ */
+typedef CHECKPOINT_RET_E (*pfn_checkpoint_token_cbk) (
+   char *pc_token,
+   uint32_t ui_token_len,
+   uint64_t ui64_count,
+   void *p_app_data);
+
+/*
+ * pc_filename is NUL terminated and is only valid for the duration of the
+ * call.
+ */
+typedef CHECKPOINT_RET_E (*pfn_checkpoint_file_cbk) (
+   char *pc_filename,
+   void *p_app_data);
+
+/***************************** FUNCTION PROTOTYPES ****************************/
+/*
+ * The checkpoint is written to "<pc_path>.tmp". checkpoint_writer_delete with
+ * b_commit set syncs it to disk and then renames it to pc_path, so a crash
+ * while writing leaves the previous checkpoint intact.
+ */
+CHECKPOINT_RET_E checkpoint_writer_create (
+   CHECKPOINT_WRITER_HDL *phl_writer_hdl,
+   char *pc_path,
+   CHECKPOINT_HEADER_X *px_header);
+
+CHECKPOINT_RET_E checkpoint_writer_add_token (
+   CHECKPOINT_WRITER_HDL hl_writer_hdl,
+   char *pc_token,
+   uint32_t ui_token_len,
+   uint64_t ui64_count);
+
+CHECKPOINT_RET_E checkpoint_writer_add_file (
+   CHECKPOINT_WRITER_HDL hl_writer_hdl,
+   char *pc_filename);
+
+/*
+ * Finishes the checkpoint and releases the handle. If b_commit is false, or
+ * any of the writes failed, the partial file is removed and the previous
+ * checkpoint is left as is.
+ */
+CHECKPOINT_RET_E checkpoint_writer_delete (
+   CHECKPOINT_WRITER_HDL hl_writer_hdl,
+   bool b_commit);
+
+CHECKPOINT_RET_E checkpoint_load (
+   char *pc_path,
+   CHECKPOINT_HEADER_X *px_header,
+   pfn_checkpoint_token_cbk fn_token_cbk,
+   pfn_checkpoint_file_cbk fn_file_cbk,
+   void *p_app_data);
+
+#endif /* __CH_IR_CHECKPOINT_H__ */
@@ -0,0 +1,496 @@
+/*******************************************************************************
+ * Copyright (c) 2026, agent <agent@local>
+ *
+ * \file   ch-ir-chunk-check.c
+ *
+ * \author agent
+ *
+ * \date   Oct 18, 2026
+ *
+ * \brief  Checks that tokenizer_feed counts the same tokens however the input
+ *         is split. Each input is fed in one piece, and then in chunks of 1, 2,
+ *         7 and 4096 bytes; the token count, the unique token count and a
+ *         checksum of every token and its count must all match. Run by
+ *         "make check".
+ *
+ *         Without arguments the fixed inputs in gxa_cases are checked first.
+ *         Their token counts are those of the line based scanner the library
+ *         replaced, so that a change in what is counted is caught and not
+ *         only a difference between chunk sizes. Then the input is generated.
+ *         It mixes words in upper and lower case with numbers, quotes, '<',
+ *         '>' and NUL bytes, so every rule of the scanner meets a chunk
+ *         boundary.
+ *
+ *         Usage:
+ *         ./ch-ir-chunk-check [<File> ...]
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ch-pal/exp_pal.h>
+#include "exp_tokenizer.h"
+
+#define CHECK_GENERATED_SIZE           (256 * 1024)
+#define CHECK_HM_TABLE_SIZE            (1024)
+#define CHECK_MAX_CASE_TOKENS          (16)
+
+/*
+ * A string literal and its length, which may include NUL bytes.
+ */
+#define CHECK_INPUT(s)                 s, (sizeof(s) - 1)
+
+typedef struct _CHECK_RESULT_X
+{
+   uint64_t ui64_num_tokens;
+
+   uint32_t ui_num_unique_tokens;
+
+   /*
+    * Sum over the tokens of a hash of the token times its count, so that it
+    * does not depend on the order of tokenizer_for_each_token.
+    */
+   uint64_t ui64_checksum;
+} CHECK_RESULT_X;
+
+typedef struct _CHECK_TOKEN_X
+{
+   const char *pc_token;
+
+   uint32_t ui_count;
+} CHECK_TOKEN_X;
+
+typedef struct _CHECK_CASE_X
+{
+   const char *pc_input;
+
+   uint32_t ui_input_len;
+
+   /*
+    * The expected tokens, in lower case, ended by a NULL pc_token.
+    */
+   CHECK_TOKEN_X xa_tokens[CHECK_MAX_CASE_TOKENS];
+} CHECK_CASE_X;
+
+static const uint32_t gua_chunk_sizes[] = {1, 2, 7, 4096};
+
+static const CHECK_CASE_X gxa_cases[] =
+{
+   {
+      /*
+       * The '.' rules. A '.' after a number is kept when a digit follows, even
+       * when the digit itself is ignored after a '<' or '>'.
+       */
+      CHECK_INPUT("12<x.5 and\n7>3.14\n0<a.1.2\n10.901 3. 1.2.3 e.g.\n"),
+      {
+         {"12.", 1}, {"7.", 1}, {"0.", 1}, {"10.901", 1}, {"3", 2},
+         {"1.2", 1}, {"e", 1}, {"g", 1}, {NULL, 0}
+      }
+   },
+   {
+      /*
+       * Delimiters, case folding, '<' and '>', and a NUL skipping the rest of
+       * its line.
+       */
+      CHECK_INPUT("The the THE, of (and)/x>y\nab\0cd ef\ngh!the\n"),
+      {
+         {"the", 4}, {"of", 1}, {"and", 1}, {"x", 1}, {"ab", 1},
+         {"gh", 1}, {NULL, 0}
+      }
+   },
+   {
+      /*
+       * Quotes are stripped after a delimiter but not before a '.'. This is
+       * where the library differs on purpose: the line based scanner gave
+       * "quotee" for 'quoted'.
+       */
+      CHECK_INPUT("'quoted' don't 'end'.\n"),
+      {
+         {"quoted", 1}, {"don't", 1}, {"'end'", 1}, {NULL, 0}
+      }
+   }
+};
+
+static uint64_t check_rand (
+   uint64_t *pui64_state);
+
+static char *check_generate_input (
+   uint32_t *pui_len);
+
+static char *check_read_file (
+   char *pc_path,
+   uint32_t *pui_len);
+
+static uint64_t check_hash (
+   const char *pc_token,
+   uint32_t ui_token_len);
+
+static TOKENIZER_RET_E fn_tokenizer_checksum_cbk (
+   const char *pc_token,
+   uint32_t ui_token_len,
+   uint64_t ui64_count,
+   void *p_app_data);
+
+static int check_tokenize (
+   const char *pc_buf,
+   uint32_t ui_len,
+   uint32_t ui_chunk_size,
+   CHECK_RESULT_X *px_result);
+
+static int check_result (
+   const char *pc_what,
+   uint32_t ui_chunk_size,
+   const CHECK_RESULT_X *px_expected,
+   const CHECK_RESULT_X *px_result);
+
+static int check_input (
+   const char *pc_name,
+   const char *pc_buf,
+   uint32_t ui_len,
+   const CHECK_RESULT_X *px_known);
+
+static int check_case (
+   uint32_t ui_case);
+
+/*
+ * xorshift64*, so that the generated input is the same everywhere.
+ */
+static uint64_t check_rand (
+   uint64_t *pui64_state)
+{
+   *pui64_state ^= *pui64_state >> 12;
+   *pui64_state ^= *pui64_state << 25;
+   *pui64_state ^= *pui64_state >> 27;
+   return *pui64_state * 2685821657736338717ULL;
+}
+
+static char *check_generate_input (
+   uint32_t *pui_len)
+{
+   static const char *ppc_words[] =
+   {
+      "the", "The", "THE", "of", "and", "tokenizer", "Hashmap", "a",
+      "'quoted'", "'open", "10", "10.901", "3.", "1.2.3", "<tag>", "x>y",
+      "averyveryverylongwordthatisnotinthehotcache", "don't", "e.g."
+   };
+   static const char ca_separators[] = "     \n\n\n,.!()/<>\0";
+   uint64_t ui64_state = 1;
+   char *pc_buf = NULL;
+   uint32_t ui_len = 0;
+   uint32_t ui_word_len = 0;
+   const char *pc_word = NULL;
+
+   pc_buf = malloc (CHECK_GENERATED_SIZE);
+   if (NULL == pc_buf)
+   {
+      goto LBL_CLEANUP;
+   }
+
+   while (1)
+   {
+      pc_word = ppc_words[check_rand (&ui64_state) %
+         (sizeof(ppc_words) / sizeof(ppc_words[0]))];
+      ui_word_len = (uint32_t) strlen (pc_word);
+      if ((ui_len + ui_word_len + 1) > CHECK_GENERATED_SIZE)
+      {
+         break;
+      }
+      (void) memcpy (pc_buf + ui_len, pc_word, ui_word_len);
+      ui_len += ui_word_len;
+      pc_buf[ui_len++] = ca_separators[check_rand (&ui64_state) %
+         (sizeof(ca_separators) - 1)];
+   }
+   *pui_len = ui_len;
+LBL_CLEANUP:
+   return pc_buf;
+}
+
+static char *check_read_file (
+   char *pc_path,
+   uint32_t *pui_len)
+{
+   FILE *p_file = NULL;
+   char *pc_buf = NULL;
+   char *pc_new_buf = NULL;
+   uint32_t ui_size = 0;
+   uint32_t ui_len = 0;
+   size_t x_read = 0;
+
+   p_file = fopen (pc_path, "r");
+   if (NULL == p_file)
+   {
+      printf ("fopen failed for \"%s\": %s\n", pc_path, strerror (errno));
+      goto LBL_CLEANUP;
+   }
+
+   do
+   {
+      if (ui_len == ui_size)
+      {
+         ui_size = (0 == ui_size) ? (64 * 1024) : (2 * ui_size);
+         pc_new_buf = realloc (pc_buf, ui_size);
+         if (NULL == pc_new_buf)
+         {
+            free (pc_buf);
+            pc_buf = NULL;
+            goto LBL_CLEANUP;
+         }
+         pc_buf = pc_new_buf;
+      }
+      x_read = fread (pc_buf + ui_len, 1, ui_size - ui_len, p_file);
+      ui_len += (uint32_t) x_read;
+   } while (x_read > 0);
+   *pui_len = ui_len;
+LBL_CLEANUP:
+   if (NULL != p_file)
+   {
+      (void) fclose (p_file);
+   }
+   return pc_buf;
+}
+
+/*
+ * FNV-1a.
+ */
+static uint64_t check_hash (
+   const char *pc_token,
+   uint32_t ui_token_len)
+{
+   uint64_t ui64_hash = 14695981039346656037ULL;
+   uint32_t ui_i = 0;
+
+   for (ui_i = 0; ui_i < ui_token_len; ui_i++)
+   {
+      ui64_hash ^= (uint8_t) pc_token[ui_i];
+      ui64_hash *= 1099511628211ULL;
+   }
+   return ui64_hash;
+}
+
+static TOKENIZER_RET_E fn_tokenizer_checksum_cbk (
+   const char *pc_token,
+   uint32_t ui_token_len,
+   uint64_t ui64_count,
+   void *p_app_data)
+{
+   CHECK_RESULT_X *px_result = NULL;
+
+   px_result = (CHECK_RESULT_X *) p_app_data;
+   px_result->ui64_checksum += check_hash (pc_token, ui_token_len) *
+      ui64_count;
+   return eTOKENIZER_RET_SUCCESS;
+}
+
+/*
+ * ui_chunk_size 0 feeds the input in one piece.
+ */
+static int check_tokenize (
+   const char *pc_buf,
+   uint32_t ui_len,
+   uint32_t ui_chunk_size,
+   CHECK_RESULT_X *px_result)
+{
+   int i_ret_val = -1;
+   TOKENIZER_HDL hl_tokenizer_hdl = NULL;
+   TOKENIZER_INIT_PARAMS_X x_init_params = {0};
+   TOKENIZER_STATS_X x_stats = {0};
+   uint32_t ui_offset = 0;
+   uint32_t ui_feed_len = 0;
+
+   x_init_params.ui_hm_table_size = CHECK_HM_TABLE_SIZE;
+   x_init_params.ui_hot_cache_size = TOKENIZER_DEFAULT_HOT_CACHE_SIZE;
+   if (eTOKENIZER_RET_SUCCESS != tokenizer_create (&hl_tokenizer_hdl,
+         &x_init_params))
+   {
+      printf ("tokenizer_create failed\n");
+      goto LBL_CLEANUP;
+   }
+
+   while (ui_offset < ui_len)
+   {
+      ui_feed_len = ui_len - ui_offset;
+      if ((0 != ui_chunk_size) && (ui_feed_len > ui_chunk_size))
+      {
+         ui_feed_len = ui_chunk_size;
+      }
+      if (eTOKENIZER_RET_SUCCESS != tokenizer_feed (hl_tokenizer_hdl,
+            pc_buf + ui_offset, ui_feed_len))
+      {
+         printf ("tokenizer_feed failed\n");
+         goto LBL_CLEANUP;
+      }
+      ui_offset += ui_feed_len;
+   }
+
+   if ((eTOKENIZER_RET_SUCCESS != tokenizer_finish (hl_tokenizer_hdl))
+      || (eTOKENIZER_RET_SUCCESS != tokenizer_get_stats (hl_tokenizer_hdl,
+         &x_stats)))
+   {
+      goto LBL_CLEANUP;
+   }
+
+   (void) memset (px_result, 0x00, sizeof(*px_result));
+   px_result->ui64_num_tokens = x_stats.ui64_num_tokens;
+   px_result->ui_num_unique_tokens = x_stats.ui_num_unique_tokens;
+   if (eTOKENIZER_RET_SUCCESS != tokenizer_for_each_token (hl_tokenizer_hdl,
+         fn_tokenizer_checksum_cbk, px_result))
+   {
+      goto LBL_CLEANUP;
+   }
+   i_ret_val = 0;
+LBL_CLEANUP:
+   if (NULL != hl_tokenizer_hdl)
+   {
+      (void) tokenizer_delete (hl_tokenizer_hdl);
+   }
+   return i_ret_val;
+}
+
+/*
+ * Feeds the input in one piece and in each of gua_chunk_sizes. The results must
+ * all be the same, and equal to *px_known if it is given.
+ */
+static int check_input (
+   const char *pc_name,
+   const char *pc_buf,
+   uint32_t ui_len,
+   const CHECK_RESULT_X *px_known)
+{
+   int i_ret_val = -1;
+   CHECK_RESULT_X x_expected = {0};
+   CHECK_RESULT_X x_result = {0};
+   uint32_t ui_i = 0;
+
+   if (0 != check_tokenize (pc_buf, ui_len, 0, &x_expected))
+   {
+      goto LBL_CLEANUP;
+   }
+   printf ("%s: %u bytes, %llu tokens, %u unique\n", pc_name, ui_len,
+      (unsigned long long) x_expected.ui64_num_tokens,
+      x_expected.ui_num_unique_tokens);
+
+   i_ret_val = 0;
+   if (NULL != px_known)
+   {
+      i_ret_val = check_result ("Whole input", 0, px_known, &x_expected);
+   }
+
+   for (ui_i = 0; ui_i < (sizeof(gua_chunk_sizes) / sizeof(gua_chunk_sizes[0]));
+      ui_i++)
+   {
+      if (0 != check_tokenize (pc_buf, ui_len, gua_chunk_sizes[ui_i],
+            &x_result))
+      {
+         i_ret_val = -1;
+         goto LBL_CLEANUP;
+      }
+      if (0 != check_result ("Chunk size", gua_chunk_sizes[ui_i], &x_expected,
+            &x_result))
+      {
+         i_ret_val = -1;
+      }
+   }
+LBL_CLEANUP:
+   return i_ret_val;
+}
+
+static int check_result (
+   const char *pc_what,
+   uint32_t ui_chunk_size,
+   const CHECK_RESULT_X *px_expected,
+   const CHECK_RESULT_X *px_result)
+{
+   int i_ret_val = -1;
+
+   if (0 == ui_chunk_size)
+   {
+      printf ("   %-15s: ", pc_what);
+   }
+   else
+   {
+      printf ("   %s %4u: ", pc_what, ui_chunk_size);
+   }
+
+   if ((px_result->ui64_num_tokens != px_expected->ui64_num_tokens)
+      || (px_result->ui_num_unique_tokens != px_expected->ui_num_unique_tokens)
+      || (px_result->ui64_checksum != px_expected->ui64_checksum))
+   {
+      printf ("FAILED, %llu tokens, %u unique\n",
+         (unsigned long long) px_result->ui64_num_tokens,
+         px_result->ui_num_unique_tokens);
+   }
+   else
+   {
+      printf ("OK\n");
+      i_ret_val = 0;
+   }
+   return i_ret_val;
+}
+
+static int check_case (
+   uint32_t ui_case)
+{
+   const CHECK_CASE_X *px_case = NULL;
+   const CHECK_TOKEN_X *px_token = NULL;
+   CHECK_RESULT_X x_known = {0};
+   char ca_name[32] = {0};
+
+   px_case = &(gxa_cases[ui_case]);
+   for (px_token = px_case->xa_tokens; NULL != px_token->pc_token; px_token++)
+   {
+      x_known.ui64_num_tokens += px_token->ui_count;
+      x_known.ui_num_unique_tokens++;
+      x_known.ui64_checksum += check_hash (px_token->pc_token,
+         (uint32_t) strlen (px_token->pc_token)) * px_token->ui_count;
+   }
+
+   (void) snprintf (ca_name, sizeof(ca_name), "fixed input %u", ui_case + 1);
+   return check_input (ca_name, px_case->pc_input, px_case->ui_input_len,
+      &x_known);
+}
+
+int main (
+   int i_argc,
+   char **ppc_argv)
+{
+   int i_ret_val = 0;
+   char *pc_buf = NULL;
+   uint32_t ui_len = 0;
+   uint32_t ui_case = 0;
+   int i_arg = 0;
+
+   if (i_argc < 2)
+   {
+      for (ui_case = 0; ui_case < (sizeof(gxa_cases) / sizeof(gxa_cases[0]));
+         ui_case++)
+      {
+         if (0 != check_case (ui_case))
+         {
+            i_ret_val = 1;
+         }
+      }
+
+      pc_buf = check_generate_input (&ui_len);
+      if ((NULL == pc_buf) || (0 != check_input ("generated input", pc_buf,
+            ui_len, NULL)))
+      {
+         i_ret_val = 1;
+      }
+      free (pc_buf);
+   }
+
+   for (i_arg = 1; i_arg < i_argc; i_arg++)
+   {
+      ui_len = 0;
+      pc_buf = check_read_file (ppc_argv[i_arg], &ui_len);
+      if ((NULL == pc_buf) || (0 != check_input (ppc_argv[i_arg], pc_buf,
+            ui_len, NULL)))
+      {
+         i_ret_val = 1;
+      }
+      free (pc_buf);
+   }
+   return i_ret_val;
+}
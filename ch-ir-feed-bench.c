@@ -0,0 +1,648 @@
+/*******************************************************************************
+ * Copyright (c) 2026, agent <agent@local>
+ *
+ * \file   ch-ir-feed-bench.c
+ *
+ * \author agent
+ *
+ * \date   Oct 18, 2026
+ *
+ * \brief  Benchmarks tokenizer_feed against the copy per token scanner it
+ *         replaced. Every regular file in the directory is read into memory
+ *         first, so only the scanning and counting are timed.
+ *
+ *         The copy per token path is the one ch-ir-tokenizer used before the
+ *         tokenizer library: the input is copied line by line into a line
+ *         buffer, every token is copied and lower cased into a token buffer
+ *         which is cleared after each token, and the NUL terminated copy is
+ *         looked up in the hashmap. Both paths run without the hot token
+ *         cache and with the same hashmap table size, so only the scanning
+ *         differs.
+ *
+ *         Usage:
+ *         ./ch-ir-feed-bench <Directory> [<Hashmap Table Size> [<Runs>]]
+ *
+ ******************************************************************************/
+
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <ch-pal/exp_pal.h>
+#include <ch-utils/exp_hashmap.h>
+#include "exp_tokenizer.h"
+
+#define BENCH_DEFAULT_HM_TABLE_SIZE    (4096)
+#define BENCH_DEFAULT_RUNS             (5)
+
+/*
+ * Buffer sizes of the copy per token path.
+ */
+#define MAX_TOKEN_SIZE                 (2048)
+#define MAX_LINE_SIZE                  (16384)
+
+typedef struct _BENCH_DOC_X
+{
+   char *pc_buf;
+
+   uint32_t ui_len;
+} BENCH_DOC_X;
+
+typedef struct _TOKEN_STATS_X
+{
+   uint8_t *puc_token;
+
+   uint32_t ui_num_occurances;
+} TOKEN_STATS_X;
+
+typedef struct _COPY_CTXT_X
+{
+   HM_HDL hl_token_hm;
+
+   uint32_t ui_num_tokens;
+
+   uint32_t ui_num_unique_tokens;
+} COPY_CTXT_X;
+
+typedef struct _BENCH_RESULT_X
+{
+   uint64_t ui64_best_ns;
+
+   uint64_t ui64_num_tokens;
+
+   uint32_t ui_num_unique_tokens;
+} BENCH_RESULT_X;
+
+static uint64_t bench_get_time_ns (
+   void);
+
+static int bench_load_docs (
+   char *pc_dir,
+   BENCH_DOC_X **ppx_docs,
+   uint32_t *pui_num_docs,
+   uint64_t *pui64_num_bytes);
+
+static void copy_handle_token (
+   COPY_CTXT_X *px_ctxt,
+   char *token);
+
+static bool copy_does_token_contain_only_numerals (
+   char *token);
+
+static void copy_parse_line (
+   COPY_CTXT_X *px_ctxt,
+   char *line);
+
+static void copy_parse_doc (
+   COPY_CTXT_X *px_ctxt,
+   BENCH_DOC_X *px_doc);
+
+static HM_RET_E fn_hm_delete_cbk (
+   HM_NODE_DATA_X *px_curr_node_data,
+   void *p_app_data);
+
+static int bench_copy_per_token (
+   BENCH_DOC_X *px_docs,
+   uint32_t ui_num_docs,
+   uint32_t ui_hm_table_size,
+   BENCH_RESULT_X *px_result);
+
+static int bench_feed (
+   BENCH_DOC_X *px_docs,
+   uint32_t ui_num_docs,
+   uint32_t ui_hm_table_size,
+   BENCH_RESULT_X *px_result);
+
+static uint64_t bench_get_time_ns (
+   void)
+{
+   struct timespec x_ts = {0};
+
+   (void) clock_gettime (CLOCK_MONOTONIC, &x_ts);
+   return ((uint64_t) x_ts.tv_sec * 1000000000ULL) + (uint64_t) x_ts.tv_nsec;
+}
+
+static int bench_load_docs (
+   char *pc_dir,
+   BENCH_DOC_X **ppx_docs,
+   uint32_t *pui_num_docs,
+   uint64_t *pui64_num_bytes)
+{
+   int i_ret_val = -1;
+   DIR *p_dir = NULL;
+   struct dirent *px_dirent = NULL;
+   struct stat x_stat = {0};
+   char *pc_path = NULL;
+   size_t x_path_size = 0;
+   FILE *p_file = NULL;
+   BENCH_DOC_X *px_docs = NULL;
+   BENCH_DOC_X *px_new_docs = NULL;
+   uint32_t ui_num_docs = 0;
+   uint32_t ui_max_docs = 0;
+   char *pc_buf = NULL;
+
+   p_dir = opendir (pc_dir);
+   if (NULL == p_dir)
+   {
+      printf ("opendir failed for \"%s\": %s\n", pc_dir, strerror (errno));
+      goto LBL_CLEANUP;
+   }
+
+   while (NULL != (px_dirent = readdir (p_dir)))
+   {
+      x_path_size = strlen (pc_dir) + strlen (px_dirent->d_name) + 2;
+      pc_path = malloc (x_path_size);
+      if (NULL == pc_path)
+      {
+         goto LBL_CLEANUP;
+      }
+      (void) snprintf (pc_path, x_path_size, "%s/%s", pc_dir,
+         px_dirent->d_name);
+      if ((0 != stat (pc_path, &x_stat)) || (!S_ISREG(x_stat.st_mode)))
+      {
+         free (pc_path);
+         pc_path = NULL;
+         continue;
+      }
+
+      if (ui_num_docs == ui_max_docs)
+      {
+         ui_max_docs = (0 == ui_max_docs) ? 256 : (2 * ui_max_docs);
+         px_new_docs = realloc (px_docs, ui_max_docs * sizeof(BENCH_DOC_X));
+         if (NULL == px_new_docs)
+         {
+            goto LBL_CLEANUP;
+         }
+         px_docs = px_new_docs;
+      }
+
+      pc_buf = malloc ((size_t) x_stat.st_size + 1);
+      p_file = fopen (pc_path, "r");
+      if ((NULL == pc_buf) || (NULL == p_file)
+         || (fread (pc_buf, 1, (size_t) x_stat.st_size, p_file) !=
+            (size_t) x_stat.st_size))
+      {
+         printf ("Reading \"%s\" failed\n", pc_path);
+         goto LBL_CLEANUP;
+      }
+      (void) fclose (p_file);
+      p_file = NULL;
+      free (pc_path);
+      pc_path = NULL;
+
+      px_docs[ui_num_docs].pc_buf = pc_buf;
+      px_docs[ui_num_docs].ui_len = (uint32_t) x_stat.st_size;
+      ui_num_docs++;
+      pc_buf = NULL;
+      *pui64_num_bytes += (uint64_t) x_stat.st_size;
+   }
+
+   *ppx_docs = px_docs;
+   *pui_num_docs = ui_num_docs;
+   px_docs = NULL;
+   i_ret_val = 0;
+LBL_CLEANUP:
+   if (NULL != px_docs)
+   {
+      while (ui_num_docs > 0)
+      {
+         free (px_docs[--ui_num_docs].pc_buf);
+      }
+      free (px_docs);
+   }
+   if (NULL != pc_buf)
+   {
+      free (pc_buf);
+   }
+   if (NULL != p_file)
+   {
+      (void) fclose (p_file);
+   }
+   if (NULL != pc_path)
+   {
+      free (pc_path);
+   }
+   if (NULL != p_dir)
+   {
+      (void) closedir (p_dir);
+   }
+   return i_ret_val;
+}
+
+static void copy_handle_token (
+   COPY_CTXT_X *px_ctxt,
+   char *token)
+{
+   HM_RET_E e_hm_ret = eHM_RET_FAILURE;
+   HM_NODE_DATA_X x_node_data = {eHM_KEY_TYPE_INVALID};
+   TOKEN_STATS_X *px_token_stats = NULL;
+   uint32_t ui_token_len = 0;
+
+   px_ctxt->ui_num_tokens++;
+
+   (void) pal_memset (&x_node_data, 0x00, sizeof(x_node_data));
+   x_node_data.e_hm_key_type = eHM_KEY_TYPE_STRING;
+   x_node_data.u_hm_key.puc_str_key = (uint8_t *) token;
+   e_hm_ret = hm_search_node (px_ctxt->hl_token_hm, &x_node_data);
+   if (eHM_RET_HM_NODE_FOUND == e_hm_ret)
+   {
+      px_token_stats = (TOKEN_STATS_X *) x_node_data.p_data;
+      px_token_stats->ui_num_occurances++;
+      return;
+   }
+
+   px_token_stats = pal_malloc (sizeof(TOKEN_STATS_X), NULL);
+   ui_token_len = pal_strlen (token) + 1;
+   px_token_stats->puc_token = pal_malloc (ui_token_len, NULL);
+   (void) pal_strncpy (px_token_stats->puc_token, (uint8_t *) token,
+      ui_token_len);
+   px_token_stats->ui_num_occurances = 1;
+
+   (void) pal_memset (&x_node_data, 0x00, sizeof(x_node_data));
+   x_node_data.e_hm_key_type = eHM_KEY_TYPE_STRING;
+   x_node_data.u_hm_key.puc_str_key = (uint8_t *) token;
+   x_node_data.p_data = px_token_stats;
+   x_node_data.ui_data_size = sizeof(*px_token_stats);
+   if (eHM_RET_SUCCESS == hm_add_node (px_ctxt->hl_token_hm, &x_node_data))
+   {
+      px_ctxt->ui_num_unique_tokens++;
+   }
+}
+
+static bool copy_does_token_contain_only_numerals (
+   char *token)
+{
+   char c = 0;
+   uint32_t ui_i = 0;
+
+   ui_i = pal_strlen (token) - 1;
+
+   while (ui_i > 0)
+   {
+      c = token[ui_i];
+
+      if (c < '0' || c > '9')
+      {
+         break;
+      }
+
+      ui_i--;
+   }
+
+   return (0 == ui_i);
+}
+
+static void copy_parse_line (
+   COPY_CTXT_X *px_ctxt,
+   char *line)
+{
+   char c = 0;
+   uint32_t ui_i = 0;
+   bool b_ignore = false;
+   bool b_break = false;
+   char ca_token[MAX_TOKEN_SIZE] = {0};
+   uint32_t ui_token_len = 0;
+
+   while (1)
+   {
+      c = line[ui_i];
+
+      switch (c)
+      {
+         case '\0':
+         {
+            if (ui_token_len > 0)
+            {
+               ca_token [ui_token_len] = '\0';
+
+               if ('\'' == ca_token[0] && '\'' == ca_token [ui_token_len - 1])
+               {
+                  pal_memmove (ca_token, &ca_token[1], ui_token_len - 2);
+                  ca_token [ui_token_len - 2] = '\0';
+               }
+
+               copy_handle_token (px_ctxt, ca_token);
+
+               (void) pal_memset (ca_token, 0x00, sizeof(ca_token));
+               ui_token_len = 0;
+            }
+            b_break = true;
+            break;
+         }
+         case '<':
+         case '>':
+         {
+            b_ignore = true;
+            break;
+         }
+         case '.':
+         {
+            if (ui_token_len > 0)
+            {
+               ca_token [ui_token_len] = '\0';
+
+               if ((true == copy_does_token_contain_only_numerals (ca_token))
+                  && ('\0' != line[ui_i + 1])
+                  && ((line[ui_i + 1] >= '0') && (line[ui_i + 1] <= '9')))
+               {
+                  ca_token [ui_token_len] = '.';
+                  ui_token_len++;
+               }
+               else
+               {
+                  copy_handle_token (px_ctxt, ca_token);
+
+                  (void) pal_memset (ca_token, 0x00, sizeof(ca_token));
+                  ui_token_len = 0;
+               }
+            }
+            break;
+         }
+         case ',':
+         case '!':
+         case ' ':
+         case '(':
+         case ')':
+         case '/':
+         {
+            if (ui_token_len > 0)
+            {
+               ca_token [ui_token_len] = '\0';
+
+               if ('\'' == ca_token[0] && '\'' == ca_token [ui_token_len - 1])
+               {
+                  pal_memmove (ca_token, &ca_token[1], ui_token_len - 3);
+                  ca_token [ui_token_len - 2] = '\0';
+               }
+
+               copy_handle_token (px_ctxt, ca_token);
+
+               (void) pal_memset (ca_token, 0x00, sizeof(ca_token));
+               ui_token_len = 0;
+            }
+            break;
+         }
+         default:
+         {
+            if ((false == b_ignore) && (ui_token_len < (MAX_TOKEN_SIZE - 1)))
+            {
+               ca_token[ui_token_len] = tolower (c);
+               ui_token_len++;
+            }
+         }
+      }
+
+      if (true == b_break)
+      {
+         break;
+      }
+
+      ui_i++;
+   }
+}
+
+/*
+ * Copies the document line by line into a line buffer, the way
+ * pal_freadline did, without the '\n'.
+ */
+static void copy_parse_doc (
+   COPY_CTXT_X *px_ctxt,
+   BENCH_DOC_X *px_doc)
+{
+   char ca_line[MAX_LINE_SIZE] = {0};
+   uint32_t ui_i = 0;
+   uint32_t ui_line_len = 0;
+
+   while (ui_i < px_doc->ui_len)
+   {
+      ui_line_len = 0;
+      while ((ui_i < px_doc->ui_len) && ('\n' != px_doc->pc_buf[ui_i])
+         && (ui_line_len < (MAX_LINE_SIZE - 1)))
+      {
+         ca_line[ui_line_len++] = px_doc->pc_buf[ui_i++];
+      }
+      if ((ui_i < px_doc->ui_len) && ('\n' == px_doc->pc_buf[ui_i]))
+      {
+         ui_i++;
+      }
+      ca_line[ui_line_len] = '\0';
+
+      copy_parse_line (px_ctxt, ca_line);
+   }
+}
+
+static HM_RET_E fn_hm_delete_cbk (
+   HM_NODE_DATA_X *px_curr_node_data,
+   void *p_app_data)
+{
+   TOKEN_STATS_X *px_token_stats = NULL;
+
+   (void) p_app_data;
+
+   px_token_stats = (TOKEN_STATS_X *) px_curr_node_data->p_data;
+   if (NULL != px_token_stats)
+   {
+      pal_free (px_token_stats->puc_token);
+      pal_free (px_token_stats);
+   }
+   return eHM_RET_SUCCESS;
+}
+
+static int bench_copy_per_token (
+   BENCH_DOC_X *px_docs,
+   uint32_t ui_num_docs,
+   uint32_t ui_hm_table_size,
+   BENCH_RESULT_X *px_result)
+{
+   COPY_CTXT_X x_ctxt = {NULL};
+   HM_INIT_PARAMS_X x_hm_init_params = {0};
+   uint64_t ui64_start_ns = 0;
+   uint64_t ui64_ns = 0;
+   uint32_t ui_i = 0;
+
+   x_hm_init_params.e_hm_key_type = eHM_KEY_TYPE_STRING;
+   x_hm_init_params.ui_hm_table_size = ui_hm_table_size;
+   if (eHM_RET_SUCCESS != hm_create (&(x_ctxt.hl_token_hm),
+         &x_hm_init_params))
+   {
+      printf ("hm_create failed\n");
+      return -1;
+   }
+
+   ui64_start_ns = bench_get_time_ns ();
+   for (ui_i = 0; ui_i < ui_num_docs; ui_i++)
+   {
+      copy_parse_doc (&x_ctxt, &(px_docs[ui_i]));
+   }
+   ui64_ns = bench_get_time_ns () - ui64_start_ns;
+
+   if ((0 == px_result->ui64_best_ns) || (ui64_ns < px_result->ui64_best_ns))
+   {
+      px_result->ui64_best_ns = ui64_ns;
+   }
+   px_result->ui64_num_tokens = x_ctxt.ui_num_tokens;
+   px_result->ui_num_unique_tokens = x_ctxt.ui_num_unique_tokens;
+
+   (void) hm_for_each (x_ctxt.hl_token_hm, fn_hm_delete_cbk, NULL);
+   (void) hm_delete (x_ctxt.hl_token_hm);
+   return 0;
+}
+
+static int bench_feed (
+   BENCH_DOC_X *px_docs,
+   uint32_t ui_num_docs,
+   uint32_t ui_hm_table_size,
+   BENCH_RESULT_X *px_result)
+{
+   int i_ret_val = -1;
+   TOKENIZER_HDL hl_tokenizer_hdl = NULL;
+   TOKENIZER_INIT_PARAMS_X x_init_params = {0};
+   TOKENIZER_STATS_X x_stats = {0};
+   uint64_t ui64_start_ns = 0;
+   uint64_t ui64_ns = 0;
+   uint32_t ui_i = 0;
+
+   x_init_params.ui_hm_table_size = ui_hm_table_size;
+   x_init_params.ui_hot_cache_size = 0;
+   if (eTOKENIZER_RET_SUCCESS != tokenizer_create (&hl_tokenizer_hdl,
+         &x_init_params))
+   {
+      printf ("tokenizer_create failed\n");
+      goto LBL_CLEANUP;
+   }
+
+   ui64_start_ns = bench_get_time_ns ();
+   for (ui_i = 0; ui_i < ui_num_docs; ui_i++)
+   {
+      if ((eTOKENIZER_RET_SUCCESS != tokenizer_feed (hl_tokenizer_hdl,
+            px_docs[ui_i].pc_buf, px_docs[ui_i].ui_len))
+         || (eTOKENIZER_RET_SUCCESS != tokenizer_finish (hl_tokenizer_hdl)))
+      {
+         printf ("tokenizer_feed failed\n");
+         goto LBL_CLEANUP;
+      }
+   }
+   ui64_ns = bench_get_time_ns () - ui64_start_ns;
+
+   if (eTOKENIZER_RET_SUCCESS != tokenizer_get_stats (hl_tokenizer_hdl,
+         &x_stats))
+   {
+      goto LBL_CLEANUP;
+   }
+
+   if ((0 == px_result->ui64_best_ns) || (ui64_ns < px_result->ui64_best_ns))
+   {
+      px_result->ui64_best_ns = ui64_ns;
+   }
+   px_result->ui64_num_tokens = x_stats.ui64_num_tokens;
+   px_result->ui_num_unique_tokens = x_stats.ui_num_unique_tokens;
+   i_ret_val = 0;
+LBL_CLEANUP:
+   if (NULL != hl_tokenizer_hdl)
+   {
+      (void) tokenizer_delete (hl_tokenizer_hdl);
+   }
+   return i_ret_val;
+}
+
+int main (
+   int i_argc,
+   char **ppc_argv)
+{
+   int i_ret_val = -1;
+   BENCH_DOC_X *px_docs = NULL;
+   uint32_t ui_num_docs = 0;
+   uint64_t ui64_num_bytes = 0;
+   uint32_t ui_hm_table_size = BENCH_DEFAULT_HM_TABLE_SIZE;
+   uint32_t ui_runs = BENCH_DEFAULT_RUNS;
+   BENCH_RESULT_X x_copy_result = {0};
+   BENCH_RESULT_X x_feed_result = {0};
+   uint32_t ui_i = 0;
+
+   if ((i_argc < 2) || (i_argc > 4))
+   {
+      printf ("\n Usage:"
+         "\n \t%s <Directory> [<Hashmap Table Size (Default: %d)> "
+         "[<Runs (Default: %d)>]]\n", ppc_argv[0],
+         BENCH_DEFAULT_HM_TABLE_SIZE, BENCH_DEFAULT_RUNS);
+      goto LBL_CLEANUP;
+   }
+   if (i_argc > 2)
+   {
+      ui_hm_table_size = (uint32_t) strtoul (ppc_argv[2], NULL, 10);
+   }
+   if (i_argc > 3)
+   {
+      ui_runs = (uint32_t) strtoul (ppc_argv[3], NULL, 10);
+   }
+   if ((0 == ui_hm_table_size) || (0 == ui_runs))
+   {
+      printf ("The table size and the number of runs must not be 0\n");
+      goto LBL_CLEANUP;
+   }
+
+   if (0 != bench_load_docs (ppc_argv[1], &px_docs, &ui_num_docs,
+         &ui64_num_bytes))
+   {
+      goto LBL_CLEANUP;
+   }
+
+   for (ui_i = 0; ui_i < ui_runs; ui_i++)
+   {
+      if ((0 != bench_copy_per_token (px_docs, ui_num_docs, ui_hm_table_size,
+            &x_copy_result))
+         || (0 != bench_feed (px_docs, ui_num_docs, ui_hm_table_size,
+            &x_feed_result)))
+      {
+         goto LBL_CLEANUP;
+      }
+   }
+
+   printf ("tokenizer_feed benchmark, best of %u runs on %s "
+      "(%u files, %llu bytes, in memory):\n", ui_runs, ppc_argv[1],
+      ui_num_docs, (unsigned long long) ui64_num_bytes);
+   printf ("| %-15s | %10s | %10s | %10s | %9s |\n", "Path", "Tokens",
+      "Unique", "Time (ms)", "ns/token");
+   printf ("| %-15s | %10llu | %10u | %10.1lf | %9.1lf |\n",
+      "copy per token", (unsigned long long) x_copy_result.ui64_num_tokens,
+      x_copy_result.ui_num_unique_tokens,
+      (double) x_copy_result.ui64_best_ns / 1000000.0,
+      (0 == x_copy_result.ui64_num_tokens) ? 0.0 :
+         ((double) x_copy_result.ui64_best_ns /
+            (double) x_copy_result.ui64_num_tokens));
+   printf ("| %-15s | %10llu | %10u | %10.1lf | %9.1lf |\n",
+      "tokenizer_feed", (unsigned long long) x_feed_result.ui64_num_tokens,
+      x_feed_result.ui_num_unique_tokens,
+      (double) x_feed_result.ui64_best_ns / 1000000.0,
+      (0 == x_feed_result.ui64_num_tokens) ? 0.0 :
+         ((double) x_feed_result.ui64_best_ns /
+            (double) x_feed_result.ui64_num_tokens));
+   if (x_feed_result.ui64_best_ns > 0)
+   {
+      printf ("Speedup: %.2lfx\n", (double) x_copy_result.ui64_best_ns /
+         (double) x_feed_result.ui64_best_ns);
+   }
+   if ((x_copy_result.ui64_num_tokens != x_feed_result.ui64_num_tokens)
+      || (x_copy_result.ui_num_unique_tokens !=
+         x_feed_result.ui_num_unique_tokens))
+   {
+      printf ("Note: the token counts differ; the copy per token path "
+         "treats quotes and over long lines differently\n");
+   }
+
+   i_ret_val = 0;
+LBL_CLEANUP:
+   if (NULL != px_docs)
+   {
+      for (ui_i = 0; ui_i < ui_num_docs; ui_i++)
+      {
+         free (px_docs[ui_i].pc_buf);
+      }
+      free (px_docs);
+   }
+   return i_ret_val;
+}
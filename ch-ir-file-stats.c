@@ -0,0 +1,559 @@
+/*******************************************************************************
+ * Copyright (c) 2026, agent <agent@local>
+ *
+ * \file   ch-ir-file-stats.c
+ *
+ * \author agent
+ *
+ * \date   Oct 18, 2026
+ *
+ * \brief  Per file timing statistics.
+ *
+ * Values are recorded in log-linear histograms in the style of HdrHistogram:
+ * every power of 2 range is split into HISTOGRAM_SUB_BUCKET_COUNT equal
+ * buckets, so a value is kept with a relative error of at most 1 in
+ * HISTOGRAM_SUB_BUCKET_COUNT whatever its magnitude, in a fixed amount of
+ * memory. Recording a value is a handful of shifts and an increment.
+ *
+ * The slowest files are kept in a min-heap on the total time, so a file
+ * which is not among the slowest seen so far costs a single comparison.
+ *
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <time.h>
+#include "ch-ir-file-stats.h"
+
+#define HISTOGRAM_SUB_BUCKET_BITS      (5)
+#define HISTOGRAM_SUB_BUCKET_COUNT     (1 << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_NUM_BUCKETS          \
+   ((64 - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKET_COUNT)
+
+typedef enum _FILE_STATS_HISTOGRAM_E
+{
+   eFILE_STATS_HISTOGRAM_READ = 0,
+
+   eFILE_STATS_HISTOGRAM_TOKENIZE,
+
+   eFILE_STATS_HISTOGRAM_TOTAL,
+
+   eFILE_STATS_HISTOGRAM_BYTES,
+
+   eFILE_STATS_HISTOGRAM_MAX
+} FILE_STATS_HISTOGRAM_E;
+
+typedef struct _FILE_STATS_HISTOGRAM_X
+{
+   uint64_t ui64a_counts[HISTOGRAM_NUM_BUCKETS];
+
+   uint64_t ui64_count;
+
+   uint64_t ui64_max;
+} FILE_STATS_HISTOGRAM_X;
+
+typedef struct _FILE_STATS_SLOW_FILE_X
+{
+   char *pc_filename;
+
+   uint64_t ui64_total_ns;
+
+   uint64_t ui64_read_ns;
+
+   uint64_t ui64_tokenize_ns;
+
+   uint64_t ui64_bytes;
+} FILE_STATS_SLOW_FILE_X;
+
+typedef struct _FILE_STATS_CTXT_X
+{
+   /*
+    * Times are recorded in microseconds, sizes in bytes.
+    */
+   FILE_STATS_HISTOGRAM_X xa_histograms[eFILE_STATS_HISTOGRAM_MAX];
+
+   /*
+    * Min-heap of the slowest files, the fastest of them at the root.
+    */
+   FILE_STATS_SLOW_FILE_X *px_slowest;
+
+   uint32_t ui_max_slowest;
+
+   uint32_t ui_num_slowest;
+} FILE_STATS_CTXT_X;
+
+static const char *gpca_histogram_names[eFILE_STATS_HISTOGRAM_MAX] =
+{
+   "Read (us)",
+   "Tokenize (us)",
+   "Total (us)",
+   "Size (bytes)"
+};
+
+static uint64_t file_stats_get_time_ns (
+   void);
+
+static uint32_t histogram_get_index (
+   uint64_t ui64_value);
+
+static uint64_t histogram_get_highest_value (
+   uint32_t ui_index);
+
+static void histogram_record (
+   FILE_STATS_HISTOGRAM_X *px_histogram,
+   uint64_t ui64_value);
+
+static uint64_t histogram_get_percentile (
+   FILE_STATS_HISTOGRAM_X *px_histogram,
+   double d_percentile);
+
+static void file_stats_sift_down (
+   FILE_STATS_CTXT_X *px_file_stats_ctxt,
+   uint32_t ui_index);
+
+static void file_stats_sift_up (
+   FILE_STATS_CTXT_X *px_file_stats_ctxt,
+   uint32_t ui_index);
+
+static int file_stats_compare_slow_files (
+   const void *p_a,
+   const void *p_b);
+
+static uint64_t file_stats_get_time_ns (
+   void)
+{
+   struct timespec x_ts = {0};
+
+   (void) clock_gettime (CLOCK_MONOTONIC, &x_ts);
+   return ((uint64_t) x_ts.tv_sec * 1000000000ULL) + (uint64_t) x_ts.tv_nsec;
+}
+
+static uint32_t histogram_get_index (
+   uint64_t ui64_value)
+{
+   uint32_t ui_shift = 0;
+
+   if (ui64_value < HISTOGRAM_SUB_BUCKET_COUNT)
+   {
+      return (uint32_t) ui64_value;
+   }
+
+   while ((ui64_value >> ui_shift) >= (2 * HISTOGRAM_SUB_BUCKET_COUNT))
+   {
+      ui_shift++;
+   }
+
+   return ((ui_shift + 1) * HISTOGRAM_SUB_BUCKET_COUNT) +
+      (uint32_t) ((ui64_value >> ui_shift) - HISTOGRAM_SUB_BUCKET_COUNT);
+}
+
+/*
+ * Largest value which falls into the bucket at ui_index.
+ */
+static uint64_t histogram_get_highest_value (
+   uint32_t ui_index)
+{
+   uint32_t ui_shift = 0;
+   uint64_t ui64_sub_bucket = 0;
+
+   if (ui_index < HISTOGRAM_SUB_BUCKET_COUNT)
+   {
+      return ui_index;
+   }
+
+   ui_shift = (ui_index / HISTOGRAM_SUB_BUCKET_COUNT) - 1;
+   ui64_sub_bucket = HISTOGRAM_SUB_BUCKET_COUNT +
+      (ui_index % HISTOGRAM_SUB_BUCKET_COUNT);
+   return ((ui64_sub_bucket + 1) << ui_shift) - 1;
+}
+
+static void histogram_record (
+   FILE_STATS_HISTOGRAM_X *px_histogram,
+   uint64_t ui64_value)
+{
+   px_histogram->ui64a_counts[histogram_get_index (ui64_value)]++;
+   px_histogram->ui64_count++;
+   if (ui64_value > px_histogram->ui64_max)
+   {
+      px_histogram->ui64_max = ui64_value;
+   }
+}
+
+static uint64_t histogram_get_percentile (
+   FILE_STATS_HISTOGRAM_X *px_histogram,
+   double d_percentile)
+{
+   uint64_t ui64_target = 0;
+   uint64_t ui64_seen = 0;
+   uint64_t ui64_value = 0;
+   uint32_t ui_i = 0;
+
+   if (0 == px_histogram->ui64_count)
+   {
+      goto LBL_CLEANUP;
+   }
+
+   ui64_target = (uint64_t) ((d_percentile / 100.0) *
+      (double) px_histogram->ui64_count + 0.5);
+   if (0 == ui64_target)
+   {
+      ui64_target = 1;
+   }
+
+   for (ui_i = 0; ui_i < HISTOGRAM_NUM_BUCKETS; ui_i++)
+   {
+      ui64_seen += px_histogram->ui64a_counts[ui_i];
+      if (ui64_seen >= ui64_target)
+      {
+         ui64_value = histogram_get_highest_value (ui_i);
+         break;
+      }
+   }
+
+   if (ui64_value > px_histogram->ui64_max)
+   {
+      ui64_value = px_histogram->ui64_max;
+   }
+LBL_CLEANUP:
+   return ui64_value;
+}
+
+static void file_stats_sift_down (
+   FILE_STATS_CTXT_X *px_file_stats_ctxt,
+   uint32_t ui_index)
+{
+   FILE_STATS_SLOW_FILE_X *px_heap = px_file_stats_ctxt->px_slowest;
+   FILE_STATS_SLOW_FILE_X x_tmp = {NULL};
+   uint32_t ui_child = 0;
+
+   while (1)
+   {
+      ui_child = (2 * ui_index) + 1;
+      if (ui_child >= px_file_stats_ctxt->ui_num_slowest)
+      {
+         break;
+      }
+      if (((ui_child + 1) < px_file_stats_ctxt->ui_num_slowest) &&
+         (px_heap[ui_child + 1].ui64_total_ns <
+            px_heap[ui_child].ui64_total_ns))
+      {
+         ui_child++;
+      }
+      if (px_heap[ui_index].ui64_total_ns <= px_heap[ui_child].ui64_total_ns)
+      {
+         break;
+      }
+      x_tmp = px_heap[ui_index];
+      px_heap[ui_index] = px_heap[ui_child];
+      px_heap[ui_child] = x_tmp;
+      ui_index = ui_child;
+   }
+}
+
+static void file_stats_sift_up (
+   FILE_STATS_CTXT_X *px_file_stats_ctxt,
+   uint32_t ui_index)
+{
+   FILE_STATS_SLOW_FILE_X *px_heap = px_file_stats_ctxt->px_slowest;
+   FILE_STATS_SLOW_FILE_X x_tmp = {NULL};
+   uint32_t ui_parent = 0;
+
+   while (ui_index > 0)
+   {
+      ui_parent = (ui_index - 1) / 2;
+      if (px_heap[ui_parent].ui64_total_ns <= px_heap[ui_index].ui64_total_ns)
+      {
+         break;
+      }
+      x_tmp = px_heap[ui_index];
+      px_heap[ui_index] = px_heap[ui_parent];
+      px_heap[ui_parent] = x_tmp;
+      ui_index = ui_parent;
+   }
+}
+
+/*
+ * Slowest first.
+ */
+static int file_stats_compare_slow_files (
+   const void *p_a,
+   const void *p_b)
+{
+   const FILE_STATS_SLOW_FILE_X *px_a = (const FILE_STATS_SLOW_FILE_X *) p_a;
+   const FILE_STATS_SLOW_FILE_X *px_b = (const FILE_STATS_SLOW_FILE_X *) p_b;
+
+   if (px_a->ui64_total_ns != px_b->ui64_total_ns)
+   {
+      return (px_a->ui64_total_ns > px_b->ui64_total_ns) ? -1 : 1;
+   }
+   return strcmp (px_a->pc_filename, px_b->pc_filename);
+}
+
+FILE_STATS_RET_E file_stats_create (
+   FILE_STATS_HDL *phl_file_stats_hdl,
+   uint32_t ui_num_slowest)
+{
+   FILE_STATS_RET_E e_file_stats_ret = eFILE_STATS_RET_FAILURE;
+   FILE_STATS_CTXT_X *px_file_stats_ctxt = NULL;
+
+   if ((NULL == phl_file_stats_hdl)
+      || (ui_num_slowest > FILE_STATS_MAX_NUM_SLOWEST))
+   {
+      e_file_stats_ret = eFILE_STATS_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   px_file_stats_ctxt = pal_malloc (sizeof(FILE_STATS_CTXT_X), NULL);
+   if (NULL == px_file_stats_ctxt)
+   {
+      e_file_stats_ret = eFILE_STATS_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+   (void) pal_memset (px_file_stats_ctxt, 0x00, sizeof(*px_file_stats_ctxt));
+
+   if (ui_num_slowest > 0)
+   {
+      px_file_stats_ctxt->px_slowest = pal_malloc (
+         ui_num_slowest * sizeof(FILE_STATS_SLOW_FILE_X), NULL);
+      if (NULL == px_file_stats_ctxt->px_slowest)
+      {
+         pal_free (px_file_stats_ctxt);
+         e_file_stats_ret = eFILE_STATS_RET_RESOURCE_FAILURE;
+         goto LBL_CLEANUP;
+      }
+      px_file_stats_ctxt->ui_max_slowest = ui_num_slowest;
+   }
+
+   *phl_file_stats_hdl = (FILE_STATS_HDL) px_file_stats_ctxt;
+   e_file_stats_ret = eFILE_STATS_RET_SUCCESS;
+LBL_CLEANUP:
+   return e_file_stats_ret;
+}
+
+void file_stats_sample_start (
+   FILE_STATS_SAMPLE_X *px_sample)
+{
+   (void) pal_memset (px_sample, 0x00, sizeof(*px_sample));
+   px_sample->ui64_mark_ns = file_stats_get_time_ns ();
+}
+
+void file_stats_sample_read (
+   FILE_STATS_SAMPLE_X *px_sample,
+   uint64_t ui64_bytes)
+{
+   uint64_t ui64_now_ns = file_stats_get_time_ns ();
+
+   px_sample->ui64_read_ns += ui64_now_ns - px_sample->ui64_mark_ns;
+   px_sample->ui64_bytes += ui64_bytes;
+   px_sample->ui64_mark_ns = ui64_now_ns;
+}
+
+void file_stats_sample_tokenize (
+   FILE_STATS_SAMPLE_X *px_sample)
+{
+   uint64_t ui64_now_ns = file_stats_get_time_ns ();
+
+   px_sample->ui64_tokenize_ns += ui64_now_ns - px_sample->ui64_mark_ns;
+   px_sample->ui64_mark_ns = ui64_now_ns;
+}
+
+FILE_STATS_RET_E file_stats_add (
+   FILE_STATS_HDL hl_file_stats_hdl,
+   char *pc_filename,
+   FILE_STATS_SAMPLE_X *px_sample)
+{
+   FILE_STATS_RET_E e_file_stats_ret = eFILE_STATS_RET_FAILURE;
+   FILE_STATS_CTXT_X *px_file_stats_ctxt = NULL;
+   FILE_STATS_SLOW_FILE_X *px_slow_file = NULL;
+   uint64_t ui64_total_ns = 0;
+   uint32_t ui_filename_len = 0;
+   char *pc_filename_copy = NULL;
+
+   if ((NULL == hl_file_stats_hdl) || (NULL == pc_filename)
+      || (NULL == px_sample))
+   {
+      e_file_stats_ret = eFILE_STATS_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   px_file_stats_ctxt = (FILE_STATS_CTXT_X *) hl_file_stats_hdl;
+   ui64_total_ns = px_sample->ui64_read_ns + px_sample->ui64_tokenize_ns;
+
+   histogram_record (
+      &(px_file_stats_ctxt->xa_histograms[eFILE_STATS_HISTOGRAM_READ]),
+      px_sample->ui64_read_ns / 1000);
+   histogram_record (
+      &(px_file_stats_ctxt->xa_histograms[eFILE_STATS_HISTOGRAM_TOKENIZE]),
+      px_sample->ui64_tokenize_ns / 1000);
+   histogram_record (
+      &(px_file_stats_ctxt->xa_histograms[eFILE_STATS_HISTOGRAM_TOTAL]),
+      ui64_total_ns / 1000);
+   histogram_record (
+      &(px_file_stats_ctxt->xa_histograms[eFILE_STATS_HISTOGRAM_BYTES]),
+      px_sample->ui64_bytes);
+
+   e_file_stats_ret = eFILE_STATS_RET_SUCCESS;
+   if ((0 == px_file_stats_ctxt->ui_max_slowest) ||
+      ((px_file_stats_ctxt->ui_num_slowest ==
+         px_file_stats_ctxt->ui_max_slowest) &&
+       (ui64_total_ns <= px_file_stats_ctxt->px_slowest[0].ui64_total_ns)))
+   {
+      goto LBL_CLEANUP;
+   }
+
+   ui_filename_len = pal_strlen (pc_filename) + 1;
+   pc_filename_copy = pal_malloc (ui_filename_len, NULL);
+   if (NULL == pc_filename_copy)
+   {
+      e_file_stats_ret = eFILE_STATS_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+   (void) pal_strncpy (pc_filename_copy, pc_filename, ui_filename_len);
+
+   if (px_file_stats_ctxt->ui_num_slowest < px_file_stats_ctxt->ui_max_slowest)
+   {
+      px_slow_file = &(px_file_stats_ctxt->px_slowest[
+         px_file_stats_ctxt->ui_num_slowest++]);
+   }
+   else
+   {
+      /*
+       * Replace the fastest of the slowest files.
+       */
+      px_slow_file = &(px_file_stats_ctxt->px_slowest[0]);
+      pal_free (px_slow_file->pc_filename);
+   }
+
+   px_slow_file->pc_filename = pc_filename_copy;
+   px_slow_file->ui64_total_ns = ui64_total_ns;
+   px_slow_file->ui64_read_ns = px_sample->ui64_read_ns;
+   px_slow_file->ui64_tokenize_ns = px_sample->ui64_tokenize_ns;
+   px_slow_file->ui64_bytes = px_sample->ui64_bytes;
+
+   if (px_slow_file == &(px_file_stats_ctxt->px_slowest[0]))
+   {
+      file_stats_sift_down (px_file_stats_ctxt, 0);
+   }
+   else
+   {
+      file_stats_sift_up (px_file_stats_ctxt,
+         (uint32_t) (px_slow_file - px_file_stats_ctxt->px_slowest));
+   }
+LBL_CLEANUP:
+   return e_file_stats_ret;
+}
+
+void file_stats_print (
+   FILE_STATS_HDL hl_file_stats_hdl)
+{
+   FILE_STATS_CTXT_X *px_file_stats_ctxt = NULL;
+   FILE_STATS_HISTOGRAM_X *px_histogram = NULL;
+   FILE_STATS_SLOW_FILE_X *px_sorted = NULL;
+   FILE_STATS_SLOW_FILE_X *px_slow_file = NULL;
+   double d_mb_per_sec = 0.0;
+   uint32_t ui_i = 0;
+
+   if (NULL == hl_file_stats_hdl)
+   {
+      goto LBL_CLEANUP;
+   }
+
+   px_file_stats_ctxt = (FILE_STATS_CTXT_X *) hl_file_stats_hdl;
+
+   printf ("\nPer File Statistics (%llu files):\n", (unsigned long long)
+      px_file_stats_ctxt->xa_histograms[eFILE_STATS_HISTOGRAM_TOTAL].ui64_count);
+   printf ("|-%13s-+-%10s-+-%10s-+-%10s-+-%10s-|\n", "-------------",
+      "----------", "----------", "----------", "----------");
+   printf ("| %13s | %10s | %10s | %10s | %10s |\n", "",
+      "p50", "p90", "p99", "Max");
+   printf ("|-%13s-+-%10s-+-%10s-+-%10s-+-%10s-|\n", "-------------",
+      "----------", "----------", "----------", "----------");
+   for (ui_i = 0; ui_i < eFILE_STATS_HISTOGRAM_MAX; ui_i++)
+   {
+      px_histogram = &(px_file_stats_ctxt->xa_histograms[ui_i]);
+      printf ("| %13s | %10llu | %10llu | %10llu | %10llu |\n",
+         gpca_histogram_names[ui_i],
+         (unsigned long long) histogram_get_percentile (px_histogram, 50.0),
+         (unsigned long long) histogram_get_percentile (px_histogram, 90.0),
+         (unsigned long long) histogram_get_percentile (px_histogram, 99.0),
+         (unsigned long long) px_histogram->ui64_max);
+   }
+   printf ("|-%13s-+-%10s-+-%10s-+-%10s-+-%10s-|\n", "-------------",
+      "----------", "----------", "----------", "----------");
+
+   if (0 == px_file_stats_ctxt->ui_num_slowest)
+   {
+      goto LBL_CLEANUP;
+   }
+
+   /*
+    * Sort a copy so that the heap stays usable.
+    */
+   px_sorted = pal_malloc (px_file_stats_ctxt->ui_num_slowest *
+      sizeof(FILE_STATS_SLOW_FILE_X), NULL);
+   if (NULL == px_sorted)
+   {
+      goto LBL_CLEANUP;
+   }
+   (void) pal_memmove (px_sorted, px_file_stats_ctxt->px_slowest,
+      px_file_stats_ctxt->ui_num_slowest * sizeof(FILE_STATS_SLOW_FILE_X));
+   qsort (px_sorted, px_file_stats_ctxt->ui_num_slowest,
+      sizeof(FILE_STATS_SLOW_FILE_X), file_stats_compare_slow_files);
+
+   printf ("\n%d slowest files:\n", px_file_stats_ctxt->ui_num_slowest);
+   printf ("|-%7s-+-%10s-+-%10s-+-%10s-+-%10s-+-%8s-+-%s\n", "-------",
+      "----------", "----------", "----------", "----------", "--------",
+      "----");
+   printf ("| %7s | %10s | %10s | %10s | %10s | %8s | %s\n", "Sl. No.",
+      "Total (us)", "Read (us)", "Tok. (us)", "Bytes", "MB/s", "File");
+   printf ("|-%7s-+-%10s-+-%10s-+-%10s-+-%10s-+-%8s-+-%s\n", "-------",
+      "----------", "----------", "----------", "----------", "--------",
+      "----");
+   for (ui_i = 0; ui_i < px_file_stats_ctxt->ui_num_slowest; ui_i++)
+   {
+      px_slow_file = &(px_sorted[ui_i]);
+      d_mb_per_sec = (0 == px_slow_file->ui64_total_ns) ? 0.0 :
+         (((double) px_slow_file->ui64_bytes * (double) 1000) /
+            (double) px_slow_file->ui64_total_ns);
+      printf ("| %7d | %10llu | %10llu | %10llu | %10llu | %8.2lf | %s\n",
+         ui_i + 1,
+         (unsigned long long) (px_slow_file->ui64_total_ns / 1000),
+         (unsigned long long) (px_slow_file->ui64_read_ns / 1000),
+         (unsigned long long) (px_slow_file->ui64_tokenize_ns / 1000),
+         (unsigned long long) px_slow_file->ui64_bytes, d_mb_per_sec,
+         px_slow_file->pc_filename);
+   }
+   printf ("|-%7s-+-%10s-+-%10s-+-%10s-+-%10s-+-%8s-+-%s\n", "-------",
+      "----------", "----------", "----------", "----------", "--------",
+      "----");
+   pal_free (px_sorted);
+LBL_CLEANUP:
+   return;
+}
+
+FILE_STATS_RET_E file_stats_delete (
+   FILE_STATS_HDL hl_file_stats_hdl)
+{
+   FILE_STATS_RET_E e_file_stats_ret = eFILE_STATS_RET_FAILURE;
+   FILE_STATS_CTXT_X *px_file_stats_ctxt = NULL;
+   uint32_t ui_i = 0;
+
+   if (NULL == hl_file_stats_hdl)
+   {
+      e_file_stats_ret = eFILE_STATS_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   px_file_stats_ctxt = (FILE_STATS_CTXT_X *) hl_file_stats_hdl;
+   for (ui_i = 0; ui_i < px_file_stats_ctxt->ui_num_slowest; ui_i++)
+   {
+      pal_free (px_file_stats_ctxt->px_slowest[ui_i].pc_filename);
+   }
+   if (NULL != px_file_stats_ctxt->px_slowest)
+   {
+      pal_free (px_file_stats_ctxt->px_slowest);
+   }
+   pal_free (px_file_stats_ctxt);
+   e_file_stats_ret = eFILE_STATS_RET_SUCCESS;
+LBL_CLEANUP:
+   return e_file_stats_ret;
+}
@@ -0,0 +1,98 @@
+/*******************************************************************************
+ * Copyright (c) 2026, agent <agent@local>
+ *
+ * \file   ch-ir-file-stats.h
+ *
+ * \author agent
+ *
+ * \date   Oct 18, 2026
+ *
+ * \brief  Per file timing statistics. The time taken to read and to tokenize
+ *         each file and its size are recorded in log-linear histograms, and
+ *         the slowest files are remembered, so that the few documents which
+ *         dominate the run time can be found.
+ *
+ ******************************************************************************/
+
+#ifndef __CH_IR_FILE_STATS_H__
+#define __CH_IR_FILE_STATS_H__
+
+#include <ch-pal/exp_pal.h>
+
+/********************************** MACROS ************************************/
+#define FILE_STATS_DEFAULT_NUM_SLOWEST (10)
+#define FILE_STATS_MAX_NUM_SLOWEST     (1000)
+
+/******************************** ENUMERATIONS ********************************/
+typedef enum _FILE_STATS_RET_E
+{
+   eFILE_STATS_RET_SUCCESS = 0,
+
+   eFILE_STATS_RET_FAILURE,
+
+   eFILE_STATS_RET_INVALID_ARGS,
+
+   eFILE_STATS_RET_RESOURCE_FAILURE
+} FILE_STATS_RET_E;
+
+/*********************** CLASS/STRUCTURE/UNION DATA TYPES *********************/
+typedef struct _FILE_STATS_CTXT_X *FILE_STATS_HDL;
+
+/*
+ * Measurements of a single file, filled in using file_stats_sample_start,
+ * file_stats_sample_read and file_stats_sample_tokenize.
+ */
+typedef struct _FILE_STATS_SAMPLE_X
+{
+   uint64_t ui64_bytes;
+
+   uint64_t ui64_read_ns;
+
+   uint64_t ui64_tokenize_ns;
+
+   /*
+    * Time at which the current step started.
+    */
+   uint64_t ui64_mark_ns;
+} FILE_STATS_SAMPLE_X;
+
+/***************************** FUNCTION PROTOTYPES ****************************/
+/*
+ * ui_num_slowest is the number of slowest files to report, up to
+ * FILE_STATS_MAX_NUM_SLOWEST.
+ */
+FILE_STATS_RET_E file_stats_create (
+   FILE_STATS_HDL *phl_file_stats_hdl,
+   uint32_t ui_num_slowest);
+
+void file_stats_sample_start (
+   FILE_STATS_SAMPLE_X *px_sample);
+
+/*
+ * Charges the time since the previous step to reading ui64_bytes bytes.
+ */
+void file_stats_sample_read (
+   FILE_STATS_SAMPLE_X *px_sample,
+   uint64_t ui64_bytes);
+
+/*
+ * Charges the time since the previous step to tokenizing.
+ */
+void file_stats_sample_tokenize (
+   FILE_STATS_SAMPLE_X *px_sample);
+
+/*
+ * pc_filename is copied only if the file is among the slowest so far.
+ */
+FILE_STATS_RET_E file_stats_add (
+   FILE_STATS_HDL hl_file_stats_hdl,
+   char *pc_filename,
+   FILE_STATS_SAMPLE_X *px_sample);
+
+void file_stats_print (
+   FILE_STATS_HDL hl_file_stats_hdl);
+
+FILE_STATS_RET_E file_stats_delete (
+   FILE_STATS_HDL hl_file_stats_hdl);
+
+#endif /* __CH_IR_FILE_STATS_H__ */
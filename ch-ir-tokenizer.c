@@ -47,36 +47,95 @@
  *
  * 2. Application Usage:
  *    Usage:
- *    ./ch-ir-tokenizer <Directory To Parse> [<Hashmap Table Size>]
+ *    ./ch-ir-tokenizer [<Options>] <Directory To Parse> [<Hashmap Table Size>]
  *       Directory To Parse - Absolute or relative directory path to parse files.
+ *                            The directory is walked recursively.
  *       Hashmap Table Size - Table size of the hashmap. Smaller the table size
  *                            slower is the run time. [Optional]
+ *    Options:
+ *       -t <Threads>       - Number of directory traversal threads.
+ *       -i <Glob>          - Only parse files matching the glob. Can be
+ *                            repeated.
+ *       -x <Glob>          - Skip files and directories matching the glob.
+ *                            Can be repeated.
+ *       -l <skip|files|all>- Symbolic link policy. Default: skip.
+ *       -s                 - Parse the files in sorted order.
+ *       -c <Entries>       - Number of entries in the hot token cache, a
+ *                            power of 2. 0 disables the cache.
+ *       -k <File>          - Periodically save a checkpoint to the file.
+ *       -n <Files>         - Save a checkpoint every given number of files.
+ *       -T <Seconds>       - Save a checkpoint every given number of seconds.
+ *       -r                 - Resume from the checkpoint given with -k.
+ *       -p <Files>         - Print per file latency and size percentiles and
+ *                            the given number of slowest files.
+ *    All the options have long forms, see print_usage.
  *
  ******************************************************************************/
 
-#include <ctype.h>
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
 #include <ch-pal/exp_pal.h>
 #include <ch-utils/exp_list.h>
-#include <ch-utils/exp_hashmap.h>
-
-#define DEFAULT_DIRECTORY_TO_PARSE     "./Cranfield"
-#define MAX_TOKEN_SIZE                 (2048)
-#define MAX_LINE_SIZE                  (16384)
-#define MAX_FILENAME_LEN               (16384)
-#define DEFAULT_HASHMAP_TABLE_SIZE     (1000)
-
-static uint32_t ui_top_30_count = 0;
+#include "exp_tokenizer.h"
+#include "ch-ir-walker.h"
+#include "ch-ir-checkpoint.h"
+#include "ch-ir-file-stats.h"
+
+#define READ_BUFFER_SIZE               (256 * 1024)
+#define DEFAULT_HASHMAP_TABLE_SIZE     TOKENIZER_DEFAULT_HM_TABLE_SIZE
+#define MAX_GLOBS                      (64)
+#define DEFAULT_HOT_CACHE_SIZE         TOKENIZER_DEFAULT_HOT_CACHE_SIZE
+#define DEFAULT_CHECKPOINT_INTERVAL_SEC (300)
+
+/*
+ * The per file timing hooks expand to nothing when the statistics are
+ * compiled out, see --disable-file-stats.
+ */
+#ifdef ENABLE_FILE_STATS
+#define FILE_STATS_READ_DONE(px_sample, ui64_bytes)                           \
+   do                                                                         \
+   {                                                                          \
+      if (NULL != (px_sample))                                                \
+      {                                                                       \
+         file_stats_sample_read ((px_sample), (ui64_bytes));                  \
+      }                                                                       \
+   } while (0)
+#define FILE_STATS_TOKENIZE_DONE(px_sample)                                   \
+   do                                                                         \
+   {                                                                          \
+      if (NULL != (px_sample))                                                \
+      {                                                                       \
+         file_stats_sample_tokenize ((px_sample));                            \
+      }                                                                       \
+   } while (0)
+#else
+#define FILE_STATS_READ_DONE(px_sample, ui64_bytes)
+#define FILE_STATS_TOKENIZE_DONE(px_sample)
+#endif
 
 typedef struct _TOKEN_STATS_X
 {
    uint8_t *puc_token;
 
-   uint32_t ui_num_occurances;
+   uint64_t ui64_num_occurances;
 } TOKEN_STATS_X;
 
-typedef struct _TOKENIZER_CTXT_X
+typedef struct _CLI_CTXT_X
 {
-   HM_HDL hl_token_hm;
+   TOKENIZER_HDL hl_tokenizer_hdl;
+
+   /*
+    * Files are read into this buffer and fed to the tokenizer from there.
+    */
+   char *pc_read_buf;
 
    LIST_HDL hl_token_list;
 
@@ -84,285 +143,272 @@ typedef struct _TOKENIZER_CTXT_X
 
    uint32_t ui_one_occur_token;
 
-   uint32_t ui_num_tokens;
+   uint64_t ui64_num_tokens;
 
    uint32_t ui_num_docs;
 
-   TOKEN_STATS_X xa_top_30[30];
-} TOKENIZER_CTXT_X;
+   /*
+    * Hot token cache statistics of the runs before a resume.
+    */
+   uint64_t ui64_resumed_hot_cache_hits;
 
-static void handle_token (
-   TOKENIZER_CTXT_X *px_tok_ctxt,
-   char *token);
+   uint64_t ui64_resumed_hot_cache_lookups;
 
-static bool does_token_contain_only_numerals(
-   char *token);
+   uint32_t ui_top_30_count;
 
-static void parse_line(
-   TOKENIZER_CTXT_X *px_tok_ctxt,
-   char *line);
+   /*
+    * NULL unless the per file statistics were asked for.
+    */
+   FILE_STATS_HDL hl_file_stats_hdl;
+} CLI_CTXT_X;
 
-static void parse_file(
-   TOKENIZER_CTXT_X *px_tok_ctxt,
-   char *filename);
+typedef struct _CHECKPOINT_TOKEN_RECORD_X
+{
+   uint32_t ui_offset;
 
-static LIST_RET_E fn_list_compare_fn_cbk (
-  LIST_NODE_DATA_X *px_app_list_node_data,
-  LIST_NODE_DATA_X *px_curr_list_node_data,
-  void *p_app_data);
+   uint32_t ui_token_len;
 
-static HM_RET_E fn_hm_for_each_cbk (
-   HM_NODE_DATA_X *px_curr_node_data,
-   void *p_app_data);
+   uint64_t ui64_count;
+} CHECKPOINT_TOKEN_RECORD_X;
 
-static LIST_RET_E fn_list_for_all_cbk(
-   LIST_NODE_DATA_X *px_node_data,
-   void *p_app_data);
+/*
+ * The contents of a checkpoint, copied by the main thread so that the writer
+ * thread never touches the live table. The buffers are reused from one
+ * checkpoint to the next.
+ */
+typedef struct _CHECKPOINT_SNAPSHOT_X
+{
+   CHECKPOINT_HEADER_X x_header;
 
-static LIST_RET_E fn_list_for_all_delete_cbk (
-   LIST_NODE_DATA_X *px_node_data,
-   void *p_app_data);
+   /*
+    * The token strings, back to back and without terminators.
+    */
+   char *pc_tokens;
 
-static void print_usage(
-   int i_argc,
-   char **ppc_argv);
+   uint32_t ui_tokens_size;
 
-static void handle_token (
-   TOKENIZER_CTXT_X *px_tok_ctxt,
-   char *token)
-{
-   HM_RET_E e_hm_ret = eHM_RET_FAILURE;
-   HM_NODE_DATA_X x_node_data = { eHM_KEY_TYPE_INVALID };
-   TOKEN_STATS_X *px_token_stats = NULL;
-   uint32_t ui_token_len = 0;
+   uint32_t ui_max_tokens_size;
 
-   px_tok_ctxt->ui_num_tokens++;
+   CHECKPOINT_TOKEN_RECORD_X *px_records;
 
-   (void) pal_memset (&x_node_data, 0x00, sizeof(x_node_data));
-   x_node_data.e_hm_key_type = eHM_KEY_TYPE_STRING;
-   x_node_data.u_hm_key.puc_str_key = token;
-   e_hm_ret = hm_search_node (px_tok_ctxt->hl_token_hm, &x_node_data);
-   if (eHM_RET_HM_NODE_FOUND == e_hm_ret)
-   {
-      px_token_stats = (TOKEN_STATS_X *) x_node_data.p_data;
-      px_token_stats->ui_num_occurances++;
-   }
-   else
-   {
-      px_token_stats = pal_malloc (sizeof(TOKEN_STATS_X), NULL);
+   uint32_t ui_num_records;
 
-      ui_token_len = pal_strlen (token);
-      px_token_stats->puc_token = pal_malloc (ui_token_len, NULL);
+   uint32_t ui_max_records;
 
-      pal_strncpy(px_token_stats->puc_token, token, ui_token_len);
-      px_token_stats->ui_num_occurances++;
-      //printf ("Count: %d\n", px_token_stats->ui_num_occurances);
+   /*
+    * The names are owned by CHECKPOINT_CTXT_X.ppc_done_files and are only
+    * freed after the writer has been joined.
+    */
+   char **ppc_done_files;
 
-      (void) pal_memset (&x_node_data, 0x00, sizeof(x_node_data));
-      x_node_data.e_hm_key_type = eHM_KEY_TYPE_STRING;
-      x_node_data.u_hm_key.puc_str_key = token;
-      x_node_data.p_data = px_token_stats;
-      x_node_data.ui_data_size = sizeof(*px_token_stats);
-      e_hm_ret = hm_add_node (px_tok_ctxt->hl_token_hm, &x_node_data);
-      if (eHM_RET_SUCCESS == e_hm_ret)
-      {
-      }
-      else
-      {
-         printf ("Key \"%s\" Add failed: %p\n", token, x_node_data.p_data);
-      }
-   }
-}
+   uint32_t ui_num_done_files;
+
+   uint32_t ui_max_done_files;
+} CHECKPOINT_SNAPSHOT_X;
 
-static bool does_token_contain_only_numerals(
-   char *token)
+typedef struct _CHECKPOINT_CTXT_X
 {
-   bool b_only_numerals = false;
-   char c = 0;
-   uint32_t ui_i = 0;
+   CLI_CTXT_X *px_tok_ctxt;
 
-   ui_i = pal_strlen (token) - 1;
+   char *pc_path;
 
-   while (ui_i > 0)
-   {
-      c = token[ui_i];
+   char *pc_root_dir;
 
-      if (c < '0' || c > '9')
-      {
-         break;
-      }
+   /*
+    * A checkpoint is taken when either of the limits is reached. 0 disables
+    * the limit.
+    */
+   uint32_t ui_interval_files;
 
-      ui_i--;
-   }
+   uint32_t ui_interval_ms;
 
-   if (0 == ui_i)
-   {
-      b_only_numerals = true;
-   }
+   uint32_t ui_files_since_last;
 
-   return b_only_numerals;
-}
+   uint32_t ui_last_time_ms;
 
-static void parse_line(
-   TOKENIZER_CTXT_X *px_tok_ctxt,
-   char *line)
-{
-   HM_RET_E e_hm_ret = eHM_RET_FAILURE;
-   char c = 0;
-   uint32_t ui_i = 0;
-   bool b_ignore = false;
-   bool b_break = false;
-   char ca_token[MAX_TOKEN_SIZE] = {0};
-   uint32_t ui_token_len = 0;
-   HM_NODE_DATA_X x_node_data = {eHM_KEY_TYPE_INVALID};
-   TOKEN_STATS_X *px_token_stats = NULL;
-   bool b_only_numerals = false;
+   /*
+    * The checkpoint is written from x_snapshot by a writer thread, so
+    * tokenization carries on while it is being written.
+    */
+   CHECKPOINT_SNAPSHOT_X x_snapshot;
 
-   while (1)
-   {
-      c = line[ui_i];
+   pthread_t x_writer_thread;
 
-      switch (c)
-      {
-         case '\0':
-         {
-            if (ui_token_len > 0)
-            {
-               ca_token [ui_token_len] = '\0';
+   /*
+    * true from the creation of the writer thread until it is joined. Only
+    * used by the main thread.
+    */
+   bool b_writer_running;
 
-               if ('\'' == ca_token[0] && '\'' == ca_token [ui_token_len - 1])
-               {
-                  pal_memmove (ca_token, &ca_token[1], ui_token_len - 2);
-                  ca_token [ui_token_len - 2] = '\0';
-               }
+   /*
+    * b_writer_done and e_writer_ret are set by the writer thread when it
+    * finishes, under x_writer_mutex.
+    */
+   bool b_writer_done;
 
-               handle_token (px_tok_ctxt, ca_token);
+   CHECKPOINT_RET_E e_writer_ret;
 
-               (void) pal_memset (ca_token, 0x00, sizeof(ca_token));
-               ui_token_len = 0;
-            }
-            b_break = true;
-            break;
-         }
-         case '<':
-         {
-            b_ignore = true;
-            break;
-         }
-         case '>':
-         {
-            b_ignore = true;
-            break;
-         }
-         case '.':
-         {
-            if (ui_token_len > 0)
-            {
-               ca_token [ui_token_len] = '\0';
-
-               b_only_numerals = does_token_contain_only_numerals (ca_token);
-               if ((true == b_only_numerals) && ('\0' != line[ui_i + 1]) &&
-                     ((line[ui_i + 1] >= '0') && (line[ui_i + 1] <= '9')))
-               {
-                  /*
-                   * Handle the following case:
-                   *    1. 10.901
-                   */
-                  ca_token [ui_token_len] = '.';
-                  ui_token_len++;
-               }
-               else
-               {
-
-                  handle_token (px_tok_ctxt, ca_token);
-
-                  (void) pal_memset (ca_token, 0x00, sizeof(ca_token));
-                  ui_token_len = 0;
-               }
-            }
-            break;
-         }
-         case ',':
-         case '!':
-         case ' ':
-         case '(':
-         case ')':
-         case '/':
-            /*
-             * All these are considered as delimiters.
-             */
-         {
-            if (ui_token_len > 0)
-            {
-               ca_token [ui_token_len] = '\0';
+   pthread_mutex_t x_writer_mutex;
 
-               if ('\'' == ca_token[0] && '\'' == ca_token [ui_token_len - 1])
-               {
-                  pal_memmove (ca_token, &ca_token[1], ui_token_len - 3);
-                  ca_token [ui_token_len - 2] = '\0';
-               }
+   /*
+    * Files which have been completely tokenized, in the order they were
+    * tokenized.
+    */
+   char **ppc_done_files;
 
-               handle_token (px_tok_ctxt, ca_token);
+   uint32_t ui_num_done_files;
 
-               (void) pal_memset (ca_token, 0x00, sizeof(ca_token));
-               ui_token_len = 0;
-            }
-            break;
-         }
-         default:
-         {
-            if (true == b_ignore)
-            {
-               break;
-            }
-            else
-            {
-               ca_token[ui_token_len] = tolower (c);
-               ui_token_len++;
-            }
-         }
-      }
+   uint32_t ui_max_done_files;
 
-      if (true == b_break)
-      {
-         break;
-      }
+   /*
+    * The files read from the checkpoint, sorted for checkpoint_is_file_done.
+    * The names are owned by ppc_done_files. Only set when resuming.
+    */
+   char **ppc_resumed_files;
 
-      ui_i++;
-   }
-}
+   uint32_t ui_num_resumed_files;
+} CHECKPOINT_CTXT_X;
 
-static void parse_file(
-   TOKENIZER_CTXT_X *px_tok_ctxt,
-   char *filename)
-{
-   PAL_RET_E e_pal_ret = ePAL_RET_FAILURE;
-   PAL_FILE_HDL hl_file_hdl = NULL;
-   uint8_t uca_line[MAX_LINE_SIZE] = {0};
-   uint32_t ui_line_len = 0;
+static bool parse_file(
+   CLI_CTXT_X *px_tok_ctxt,
+   char *filename,
+   FILE_STATS_SAMPLE_X *px_sample);
+
+static LIST_RET_E fn_list_compare_fn_cbk (
+  LIST_NODE_DATA_X *px_app_list_node_data,
+  LIST_NODE_DATA_X *px_curr_list_node_data,
+  void *p_app_data);
+
+static TOKENIZER_RET_E fn_tokenizer_for_each_cbk (
+   const char *pc_token,
+   uint32_t ui_token_len,
+   uint64_t ui64_count,
+   void *p_app_data);
+
+static LIST_RET_E fn_list_for_all_cbk(
+   LIST_NODE_DATA_X *px_node_data,
+   void *p_app_data);
+
+static TOKENIZER_RET_E fn_tokenizer_snapshot_cbk (
+   const char *pc_token,
+   uint32_t ui_token_len,
+   uint64_t ui64_count,
+   void *p_app_data);
+
+static CHECKPOINT_RET_E fn_checkpoint_token_cbk (
+   char *pc_token,
+   uint32_t ui_token_len,
+   uint64_t ui64_count,
+   void *p_app_data);
+
+static CHECKPOINT_RET_E fn_checkpoint_file_cbk (
+   char *pc_filename,
+   void *p_app_data);
 
-   e_pal_ret = pal_fopen (&hl_file_hdl, (const uint8_t *) filename,
-      (const uint8_t *) "r");
-   if (ePAL_RET_SUCCESS != e_pal_ret)
+static bool checkpoint_add_done_file (
+   CHECKPOINT_CTXT_X *px_ckpt_ctxt,
+   char *pc_filename);
+
+static int fn_done_file_compare_cbk (
+   const void *p_key,
+   const void *p_elem);
+
+static bool checkpoint_is_file_done (
+   CHECKPOINT_CTXT_X *px_ckpt_ctxt,
+   char *pc_filename);
+
+static bool checkpoint_snapshot (
+   CLI_CTXT_X *px_tok_ctxt,
+   CHECKPOINT_CTXT_X *px_ckpt_ctxt);
+
+static CHECKPOINT_RET_E checkpoint_save (
+   CHECKPOINT_SNAPSHOT_X *px_snapshot,
+   char *pc_path);
+
+static void *checkpoint_writer_thread (
+   void *p_arg);
+
+static void checkpoint_reap_writer (
+   CHECKPOINT_CTXT_X *px_ckpt_ctxt,
+   bool b_wait);
+
+static void checkpoint_take (
+   CLI_CTXT_X *px_tok_ctxt,
+   CHECKPOINT_CTXT_X *px_ckpt_ctxt);
+
+static int checkpoint_resume (
+   CLI_CTXT_X *px_tok_ctxt,
+   CHECKPOINT_CTXT_X *px_ckpt_ctxt);
+
+static void print_usage(
+   int i_argc,
+   char **ppc_argv);
+
+/*
+ * px_sample, if not NULL, is filled in with the time taken to read and to
+ * tokenize the file. Returns false if the file could not be opened or read
+ * completely, or could not be tokenized; px_sample is then incomplete.
+ */
+static bool parse_file(
+   CLI_CTXT_X *px_tok_ctxt,
+   char *filename,
+   FILE_STATS_SAMPLE_X *px_sample)
+{
+   bool b_parsed = false;
+   bool b_failed = false;
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_FAILURE;
+   int i_fd = -1;
+   ssize_t l_read = 0;
+
+   i_fd = open (filename, O_RDONLY);
+   if (-1 == i_fd)
    {
       goto LBL_CLEANUP;
    }
 
    while (1)
    {
-      e_pal_ret = pal_freadline (hl_file_hdl, uca_line, sizeof(uca_line),
-         &ui_line_len);
-      if (ePAL_RET_FILE_EOF_REACHED == e_pal_ret)
+      l_read = read (i_fd, px_tok_ctxt->pc_read_buf, READ_BUFFER_SIZE);
+      if ((-1 == l_read) && (EINTR == errno))
+      {
+         continue;
+      }
+      if (l_read <= 0)
       {
+         b_failed = (-1 == l_read);
+         break;
+      }
+      FILE_STATS_READ_DONE (px_sample, (uint64_t) l_read);
+
+      e_tok_ret = tokenizer_feed (px_tok_ctxt->hl_tokenizer_hdl,
+         px_tok_ctxt->pc_read_buf, (uint32_t) l_read);
+      FILE_STATS_TOKENIZE_DONE (px_sample);
+      if (eTOKENIZER_RET_SUCCESS != e_tok_ret)
+      {
+         printf ("tokenizer_feed failed for \"%s\": %d\n", filename,
+            e_tok_ret);
+         b_failed = true;
          break;
       }
-      parse_line (px_tok_ctxt, (char *) uca_line);
    }
 
-   e_pal_ret = pal_fclose (hl_file_hdl);
+   (void) close (i_fd);
+   FILE_STATS_READ_DONE (px_sample, 0);
 
+   /*
+    * Every file is a separate input, a token never spans two files.
+    */
+   e_tok_ret = tokenizer_finish (px_tok_ctxt->hl_tokenizer_hdl);
+   FILE_STATS_TOKENIZE_DONE (px_sample);
+   if (eTOKENIZER_RET_SUCCESS != e_tok_ret)
+   {
+      printf ("tokenizer_finish failed for \"%s\": %d\n", filename,
+         e_tok_ret);
+      goto LBL_CLEANUP;
+   }
+   b_parsed = (false == b_failed);
 LBL_CLEANUP:
-   return;
+   return b_parsed;
 }
 
 static LIST_RET_E fn_list_compare_fn_cbk (
@@ -384,8 +430,16 @@ static LIST_RET_E fn_list_compare_fn_cbk (
    px_app_node_data = (TOKEN_STATS_X *) px_app_list_node_data->p_data;
    px_curr_node_data = (TOKEN_STATS_X *) px_curr_list_node_data->p_data;
 
-   if (px_curr_node_data->ui_num_occurances
-      < px_app_node_data->ui_num_occurances)
+   /*
+    * Tokens with the same number of occurances are ordered by the token so
+    * that the report does not depend on the order of the hashmap.
+    */
+   if ((px_curr_node_data->ui64_num_occurances
+      < px_app_node_data->ui64_num_occurances) ||
+      ((px_curr_node_data->ui64_num_occurances
+         == px_app_node_data->ui64_num_occurances) &&
+       (strcmp ((char *) px_app_node_data->puc_token,
+         (char *) px_curr_node_data->puc_token) < 0)))
    {
       e_list_ret = eLIST_RET_LIST_NODE_FOUND;
    }
@@ -398,30 +452,28 @@ CLEAN_RETURN:
    return e_list_ret;
 }
 
-static HM_RET_E fn_hm_for_each_cbk (
-   HM_NODE_DATA_X *px_curr_node_data,
+static TOKENIZER_RET_E fn_tokenizer_for_each_cbk (
+   const char *pc_token,
+   uint32_t ui_token_len,
+   uint64_t ui64_count,
    void *p_app_data)
 {
-   HM_RET_E e_hm_ret = eHM_RET_FAILURE;
-   TOKEN_STATS_X *px_token_stats = NULL;
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_FAILURE;
    TOKEN_STATS_X *px_token_stats_list = NULL;
-   TOKENIZER_CTXT_X *px_tok_ctxt = NULL;
+   CLI_CTXT_X *px_tok_ctxt = NULL;
    LIST_NODE_DATA_X x_list_node_data = {0};
    LIST_RET_E e_list_ret = eLIST_RET_FAILURE;
-   uint32_t ui_token_len = 0;
 
-   px_tok_ctxt = (TOKENIZER_CTXT_X *) p_app_data;
-   px_token_stats = (TOKEN_STATS_X *) px_curr_node_data->p_data;
+   px_tok_ctxt = (CLI_CTXT_X *) p_app_data;
 
    px_token_stats_list = pal_malloc (sizeof(TOKEN_STATS_X), NULL);
 
-   ui_token_len = pal_strlen(px_token_stats->puc_token) + 1;
-   px_token_stats_list->puc_token = pal_malloc (ui_token_len, NULL);
-   pal_strncpy (px_token_stats_list->puc_token, px_token_stats->puc_token,
-      ui_token_len);
-   px_token_stats_list->ui_num_occurances = px_token_stats->ui_num_occurances;
+   px_token_stats_list->puc_token = pal_malloc (ui_token_len + 1, NULL);
+   (void) pal_memmove (px_token_stats_list->puc_token, pc_token,
+      ui_token_len + 1);
+   px_token_stats_list->ui64_num_occurances = ui64_count;
 
-   if (1 == px_token_stats->ui_num_occurances)
+   if (1 == ui64_count)
    {
       px_tok_ctxt->ui_one_occur_token++;
    }
@@ -440,14 +492,14 @@ static HM_RET_E fn_hm_for_each_cbk (
       {
          printf ("list_node_insert_sorted failed: %d\n", e_list_ret);
       }
-      e_hm_ret = eHM_RET_RESOURCE_FAILURE;
+      e_tok_ret = eTOKENIZER_RET_RESOURCE_FAILURE;
    }
    else
    {
-      e_hm_ret = eHM_RET_SUCCESS;
+      e_tok_ret = eTOKENIZER_RET_SUCCESS;
    }
 LBL_CLEANUP:
-   return e_hm_ret;
+   return e_tok_ret;
 }
 
 static LIST_RET_E fn_list_for_all_cbk(
@@ -457,7 +509,7 @@ static LIST_RET_E fn_list_for_all_cbk(
    LIST_RET_E e_error = eLIST_RET_FAILURE;
    TOKEN_STATS_X *px_list_node_data = NULL;
    TOKEN_STATS_X *px_token_stats = NULL;
-   TOKENIZER_CTXT_X *px_tok_ctxt = NULL;
+   CLI_CTXT_X *px_tok_ctxt = NULL;
    double d_frequency = 0.0;
 
    if (NULL == px_node_data)
@@ -474,21 +526,22 @@ static LIST_RET_E fn_list_for_all_cbk(
    }
 
    px_list_node_data = (TOKEN_STATS_X *) px_node_data->p_data;
-   px_tok_ctxt = (TOKENIZER_CTXT_X *) p_app_data;
+   px_tok_ctxt = (CLI_CTXT_X *) p_app_data;
 
-   ui_top_30_count++;
+   px_tok_ctxt->ui_top_30_count++;
 
-   if (31 == ui_top_30_count)
+   if (31 == px_tok_ctxt->ui_top_30_count)
    {
-      ui_top_30_count = 0;
+      px_tok_ctxt->ui_top_30_count = 0;
       e_error = eLIST_RET_FAILURE;
    }
    else
    {
-      d_frequency = (((double) px_list_node_data->ui_num_occurances /
-            (double) px_tok_ctxt->ui_num_tokens) * (double) 100);
-      printf ("| %7d | %20s | %10d | %7.4lf%% | \n", ui_top_30_count,
-         px_list_node_data->puc_token, px_list_node_data->ui_num_occurances,
+      d_frequency = (((double) px_list_node_data->ui64_num_occurances /
+            (double) px_tok_ctxt->ui64_num_tokens) * (double) 100);
+      printf ("| %7d | %20s | %10llu | %7.4lf%% | \n",
+         px_tok_ctxt->ui_top_30_count, px_list_node_data->puc_token,
+         (unsigned long long) px_list_node_data->ui64_num_occurances,
          d_frequency);
       e_error = eLIST_RET_SUCCESS;
    }
@@ -498,55 +551,493 @@ CLEAN_RETURN:
    return e_error;
 }
 
-static LIST_RET_E fn_list_for_all_delete_cbk (
-   LIST_NODE_DATA_X *px_node_data,
+static TOKENIZER_RET_E fn_tokenizer_snapshot_cbk (
+   const char *pc_token,
+   uint32_t ui_token_len,
+   uint64_t ui64_count,
    void *p_app_data)
 {
-   LIST_RET_E e_error = eLIST_RET_FAILURE;
-   TOKEN_STATS_X *px_list_node_data = NULL;
-   HM_NODE_DATA_X x_hm_node_data = {eHM_KEY_TYPE_INVALID};
-   TOKENIZER_CTXT_X *px_tok_ctxt = NULL;
-   HM_RET_E e_hm_ret = eHM_RET_FAILURE;
-   TOKEN_STATS_X *px_token_stats = NULL;
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_FAILURE;
+   CHECKPOINT_SNAPSHOT_X *px_snapshot = NULL;
+   CHECKPOINT_TOKEN_RECORD_X *px_record = NULL;
+   char *pc_tokens = NULL;
+   uint32_t ui_max_tokens_size = 0;
 
-   if (NULL == px_node_data)
+   px_snapshot = (CHECKPOINT_SNAPSHOT_X *) p_app_data;
+
+   /*
+    * px_records was sized from tokenizer_get_stats just before.
+    */
+   if (px_snapshot->ui_num_records == px_snapshot->ui_max_records)
    {
-      e_error = eLIST_RET_INVALID_ARGS;
-      goto CLEAN_RETURN;
+      goto LBL_CLEANUP;
    }
 
-   if ((NULL == px_node_data->p_data) || (0 == px_node_data->ui_data_size ||
-      (sizeof (TOKEN_STATS_X) != px_node_data->ui_data_size)))
+   if ((px_snapshot->ui_max_tokens_size - px_snapshot->ui_tokens_size) <
+      ui_token_len)
    {
-      e_error = eLIST_RET_INVALID_ARGS;
-      goto CLEAN_RETURN;
+      ui_max_tokens_size = (0 == px_snapshot->ui_max_tokens_size) ?
+         (64 * 1024) : px_snapshot->ui_max_tokens_size;
+      while ((ui_max_tokens_size - px_snapshot->ui_tokens_size) < ui_token_len)
+      {
+         if (ui_max_tokens_size > (UINT32_MAX / 2))
+         {
+            goto LBL_CLEANUP;
+         }
+         ui_max_tokens_size *= 2;
+      }
+      pc_tokens = pal_malloc (ui_max_tokens_size, NULL);
+      if (NULL == pc_tokens)
+      {
+         goto LBL_CLEANUP;
+      }
+      if (NULL != px_snapshot->pc_tokens)
+      {
+         (void) pal_memmove (pc_tokens, px_snapshot->pc_tokens,
+            px_snapshot->ui_tokens_size);
+         pal_free (px_snapshot->pc_tokens);
+      }
+      px_snapshot->pc_tokens = pc_tokens;
+      px_snapshot->ui_max_tokens_size = ui_max_tokens_size;
    }
 
-   px_list_node_data = (TOKEN_STATS_X *) px_node_data->p_data;
-   px_tok_ctxt = (TOKENIZER_CTXT_X *) p_app_data;
+   (void) pal_memmove (px_snapshot->pc_tokens + px_snapshot->ui_tokens_size,
+      pc_token, ui_token_len);
+   px_record = &(px_snapshot->px_records[px_snapshot->ui_num_records++]);
+   px_record->ui_offset = px_snapshot->ui_tokens_size;
+   px_record->ui_token_len = ui_token_len;
+   px_record->ui64_count = ui64_count;
+   px_snapshot->ui_tokens_size += ui_token_len;
+
+   e_tok_ret = eTOKENIZER_RET_SUCCESS;
+LBL_CLEANUP:
+   return e_tok_ret;
+}
+
+static CHECKPOINT_RET_E fn_checkpoint_token_cbk (
+   char *pc_token,
+   uint32_t ui_token_len,
+   uint64_t ui64_count,
+   void *p_app_data)
+{
+   CHECKPOINT_CTXT_X *px_ckpt_ctxt = NULL;
+
+   px_ckpt_ctxt = (CHECKPOINT_CTXT_X *) p_app_data;
+   if (eTOKENIZER_RET_SUCCESS != tokenizer_add_token (
+         px_ckpt_ctxt->px_tok_ctxt->hl_tokenizer_hdl, pc_token, ui_token_len,
+         ui64_count))
+   {
+      return eCHECKPOINT_RET_RESOURCE_FAILURE;
+   }
+   return eCHECKPOINT_RET_SUCCESS;
+}
+
+static CHECKPOINT_RET_E fn_checkpoint_file_cbk (
+   char *pc_filename,
+   void *p_app_data)
+{
+   CHECKPOINT_RET_E e_checkpoint_ret = eCHECKPOINT_RET_FAILURE;
+   CHECKPOINT_CTXT_X *px_ckpt_ctxt = NULL;
+   char *pc_done_file = NULL;
+   uint32_t ui_filename_len = 0;
+
+   px_ckpt_ctxt = (CHECKPOINT_CTXT_X *) p_app_data;
+
+   ui_filename_len = pal_strlen (pc_filename) + 1;
+   pc_done_file = pal_malloc (ui_filename_len, NULL);
+   if (NULL == pc_done_file)
+   {
+      e_checkpoint_ret = eCHECKPOINT_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+   (void) pal_strncpy (pc_done_file, pc_filename, ui_filename_len);
 
-   x_hm_node_data.e_hm_key_type = eHM_KEY_TYPE_STRING;
-   x_hm_node_data.u_hm_key.puc_str_key = px_list_node_data->puc_token;
-   e_hm_ret = hm_delete_node(px_tok_ctxt->hl_token_hm, &x_hm_node_data);
-   if (eHM_RET_SUCCESS == e_hm_ret)
+   if (false == checkpoint_add_done_file (px_ckpt_ctxt, pc_done_file))
    {
-      if (NULL != x_hm_node_data.p_data)
+      pal_free (pc_done_file);
+      e_checkpoint_ret = eCHECKPOINT_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+
+   e_checkpoint_ret = eCHECKPOINT_RET_SUCCESS;
+LBL_CLEANUP:
+   return e_checkpoint_ret;
+}
+
+/*
+ * Takes ownership of pc_filename on success.
+ */
+static bool checkpoint_add_done_file (
+   CHECKPOINT_CTXT_X *px_ckpt_ctxt,
+   char *pc_filename)
+{
+   bool b_added = false;
+   char **ppc_done_files = NULL;
+   uint32_t ui_max_done_files = 0;
+
+   if (px_ckpt_ctxt->ui_num_done_files == px_ckpt_ctxt->ui_max_done_files)
+   {
+      ui_max_done_files = (0 == px_ckpt_ctxt->ui_max_done_files) ?
+         1024 : (2 * px_ckpt_ctxt->ui_max_done_files);
+      ppc_done_files = pal_malloc (ui_max_done_files * sizeof(char *), NULL);
+      if (NULL == ppc_done_files)
       {
-         px_token_stats = (TOKEN_STATS_X *) x_hm_node_data.p_data;
-         if (NULL != px_token_stats->puc_token)
-         {
-            pal_free (px_token_stats->puc_token);
-            px_token_stats->puc_token = NULL;
-         }
+         goto LBL_CLEANUP;
+      }
+      if (NULL != px_ckpt_ctxt->ppc_done_files)
+      {
+         (void) pal_memmove (ppc_done_files, px_ckpt_ctxt->ppc_done_files,
+            px_ckpt_ctxt->ui_num_done_files * sizeof(char *));
+         pal_free (px_ckpt_ctxt->ppc_done_files);
+      }
+      px_ckpt_ctxt->ppc_done_files = ppc_done_files;
+      px_ckpt_ctxt->ui_max_done_files = ui_max_done_files;
+   }
+
+   px_ckpt_ctxt->ppc_done_files[px_ckpt_ctxt->ui_num_done_files++] =
+      pc_filename;
+   b_added = true;
+LBL_CLEANUP:
+   return b_added;
+}
+
+static int fn_done_file_compare_cbk (
+   const void *p_key,
+   const void *p_elem)
+{
+   return strcmp (*((char * const *) p_key), *((char * const *) p_elem));
+}
+
+static bool checkpoint_is_file_done (
+   CHECKPOINT_CTXT_X *px_ckpt_ctxt,
+   char *pc_filename)
+{
+   if (0 == px_ckpt_ctxt->ui_num_resumed_files)
+   {
+      return false;
+   }
+
+   return (NULL != bsearch (&pc_filename, px_ckpt_ctxt->ppc_resumed_files,
+      px_ckpt_ctxt->ui_num_resumed_files, sizeof(char *),
+      fn_done_file_compare_cbk));
+}
+
+/*
+ * Runs on the main thread, between files, so the table does not change while
+ * it is copied.
+ */
+static bool checkpoint_snapshot (
+   CLI_CTXT_X *px_tok_ctxt,
+   CHECKPOINT_CTXT_X *px_ckpt_ctxt)
+{
+   bool b_taken = false;
+   CHECKPOINT_SNAPSHOT_X *px_snapshot = NULL;
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_FAILURE;
+   TOKENIZER_STATS_X x_tok_stats = {0};
+   CHECKPOINT_TOKEN_RECORD_X *px_records = NULL;
+   char **ppc_done_files = NULL;
+
+   px_snapshot = &(px_ckpt_ctxt->x_snapshot);
+
+   e_tok_ret = tokenizer_get_stats (px_tok_ctxt->hl_tokenizer_hdl,
+      &x_tok_stats);
+   if (eTOKENIZER_RET_SUCCESS != e_tok_ret)
+   {
+      goto LBL_CLEANUP;
+   }
 
-         pal_free (x_hm_node_data.p_data);
-         x_hm_node_data.p_data = NULL;
+   px_snapshot->x_header.pc_root_dir = px_ckpt_ctxt->pc_root_dir;
+   px_snapshot->x_header.ui64_num_tokens = x_tok_stats.ui64_num_tokens;
+   px_snapshot->x_header.ui_num_docs = px_tok_ctxt->ui_num_docs;
+   px_snapshot->x_header.ui64_hot_cache_hits =
+      px_tok_ctxt->ui64_resumed_hot_cache_hits +
+      x_tok_stats.ui64_hot_cache_hits;
+   px_snapshot->x_header.ui64_hot_cache_lookups =
+      px_tok_ctxt->ui64_resumed_hot_cache_lookups +
+      x_tok_stats.ui64_hot_cache_lookups;
+
+   if (x_tok_stats.ui_num_unique_tokens > px_snapshot->ui_max_records)
+   {
+      px_records = pal_malloc (
+         x_tok_stats.ui_num_unique_tokens * sizeof(CHECKPOINT_TOKEN_RECORD_X),
+         NULL);
+      if (NULL == px_records)
+      {
+         goto LBL_CLEANUP;
       }
+      if (NULL != px_snapshot->px_records)
+      {
+         pal_free (px_snapshot->px_records);
+      }
+      px_snapshot->px_records = px_records;
+      px_snapshot->ui_max_records = x_tok_stats.ui_num_unique_tokens;
    }
 
-   e_error = eLIST_RET_SUCCESS;
-CLEAN_RETURN:
-   return e_error;
+   if (px_ckpt_ctxt->ui_num_done_files > px_snapshot->ui_max_done_files)
+   {
+      ppc_done_files = pal_malloc (
+         px_ckpt_ctxt->ui_max_done_files * sizeof(char *), NULL);
+      if (NULL == ppc_done_files)
+      {
+         goto LBL_CLEANUP;
+      }
+      if (NULL != px_snapshot->ppc_done_files)
+      {
+         pal_free (px_snapshot->ppc_done_files);
+      }
+      px_snapshot->ppc_done_files = ppc_done_files;
+      px_snapshot->ui_max_done_files = px_ckpt_ctxt->ui_max_done_files;
+   }
+
+   px_snapshot->ui_num_records = 0;
+   px_snapshot->ui_tokens_size = 0;
+   e_tok_ret = tokenizer_for_each_token (px_tok_ctxt->hl_tokenizer_hdl,
+      fn_tokenizer_snapshot_cbk, px_snapshot);
+   if (eTOKENIZER_RET_SUCCESS != e_tok_ret)
+   {
+      goto LBL_CLEANUP;
+   }
+
+   if (px_ckpt_ctxt->ui_num_done_files > 0)
+   {
+      (void) pal_memmove (px_snapshot->ppc_done_files,
+         px_ckpt_ctxt->ppc_done_files,
+         px_ckpt_ctxt->ui_num_done_files * sizeof(char *));
+   }
+   px_snapshot->ui_num_done_files = px_ckpt_ctxt->ui_num_done_files;
+
+   b_taken = true;
+LBL_CLEANUP:
+   return b_taken;
+}
+
+static CHECKPOINT_RET_E checkpoint_save (
+   CHECKPOINT_SNAPSHOT_X *px_snapshot,
+   char *pc_path)
+{
+   CHECKPOINT_RET_E e_checkpoint_ret = eCHECKPOINT_RET_FAILURE;
+   CHECKPOINT_WRITER_HDL hl_writer_hdl = NULL;
+   CHECKPOINT_TOKEN_RECORD_X *px_record = NULL;
+   uint32_t ui_i = 0;
+
+   e_checkpoint_ret = checkpoint_writer_create (&hl_writer_hdl, pc_path,
+      &(px_snapshot->x_header));
+   if (eCHECKPOINT_RET_SUCCESS != e_checkpoint_ret)
+   {
+      goto LBL_CLEANUP;
+   }
+
+   for (ui_i = 0; ui_i < px_snapshot->ui_num_records; ui_i++)
+   {
+      px_record = &(px_snapshot->px_records[ui_i]);
+      e_checkpoint_ret = checkpoint_writer_add_token (hl_writer_hdl,
+         px_snapshot->pc_tokens + px_record->ui_offset,
+         px_record->ui_token_len, px_record->ui64_count);
+      if (eCHECKPOINT_RET_SUCCESS != e_checkpoint_ret)
+      {
+         (void) checkpoint_writer_delete (hl_writer_hdl, false);
+         goto LBL_CLEANUP;
+      }
+   }
+
+   for (ui_i = 0; ui_i < px_snapshot->ui_num_done_files; ui_i++)
+   {
+      e_checkpoint_ret = checkpoint_writer_add_file (hl_writer_hdl,
+         px_snapshot->ppc_done_files[ui_i]);
+      if (eCHECKPOINT_RET_SUCCESS != e_checkpoint_ret)
+      {
+         (void) checkpoint_writer_delete (hl_writer_hdl, false);
+         goto LBL_CLEANUP;
+      }
+   }
+
+   e_checkpoint_ret = checkpoint_writer_delete (hl_writer_hdl, true);
+LBL_CLEANUP:
+   return e_checkpoint_ret;
+}
+
+static void *checkpoint_writer_thread (
+   void *p_arg)
+{
+   CHECKPOINT_CTXT_X *px_ckpt_ctxt = NULL;
+   CHECKPOINT_RET_E e_checkpoint_ret = eCHECKPOINT_RET_FAILURE;
+
+   px_ckpt_ctxt = (CHECKPOINT_CTXT_X *) p_arg;
+
+   e_checkpoint_ret = checkpoint_save (&(px_ckpt_ctxt->x_snapshot),
+      px_ckpt_ctxt->pc_path);
+
+   (void) pthread_mutex_lock (&(px_ckpt_ctxt->x_writer_mutex));
+   px_ckpt_ctxt->e_writer_ret = e_checkpoint_ret;
+   px_ckpt_ctxt->b_writer_done = true;
+   (void) pthread_mutex_unlock (&(px_ckpt_ctxt->x_writer_mutex));
+   return NULL;
+}
+
+static void checkpoint_reap_writer (
+   CHECKPOINT_CTXT_X *px_ckpt_ctxt,
+   bool b_wait)
+{
+   bool b_done = false;
+
+   if (false == px_ckpt_ctxt->b_writer_running)
+   {
+      goto LBL_CLEANUP;
+   }
+
+   (void) pthread_mutex_lock (&(px_ckpt_ctxt->x_writer_mutex));
+   b_done = px_ckpt_ctxt->b_writer_done;
+   (void) pthread_mutex_unlock (&(px_ckpt_ctxt->x_writer_mutex));
+   if ((false == b_done) && (false == b_wait))
+   {
+      goto LBL_CLEANUP;
+   }
+
+   (void) pthread_join (px_ckpt_ctxt->x_writer_thread, NULL);
+   px_ckpt_ctxt->b_writer_running = false;
+   if (eCHECKPOINT_RET_SUCCESS != px_ckpt_ctxt->e_writer_ret)
+   {
+      printf ("Checkpoint \"%s\" could not be written\n",
+         px_ckpt_ctxt->pc_path);
+   }
+LBL_CLEANUP:
+   return;
+}
+
+static void checkpoint_take (
+   CLI_CTXT_X *px_tok_ctxt,
+   CHECKPOINT_CTXT_X *px_ckpt_ctxt)
+{
+   CHECKPOINT_RET_E e_checkpoint_ret = eCHECKPOINT_RET_FAILURE;
+   int i_ret_val = -1;
+
+   checkpoint_reap_writer (px_ckpt_ctxt, false);
+   if (true == px_ckpt_ctxt->b_writer_running)
+   {
+      /*
+       * The previous checkpoint is still being written. Try again after the
+       * next file.
+       */
+      goto LBL_CLEANUP;
+   }
+
+   px_ckpt_ctxt->ui_files_since_last = 0;
+   px_ckpt_ctxt->ui_last_time_ms = pal_get_system_time_ms ();
+
+   if (false == checkpoint_snapshot (px_tok_ctxt, px_ckpt_ctxt))
+   {
+      printf ("Checkpoint \"%s\" could not be written\n",
+         px_ckpt_ctxt->pc_path);
+      goto LBL_CLEANUP;
+   }
+
+   /*
+    * No writer thread is running, so the flag can be reset without the lock.
+    */
+   px_ckpt_ctxt->b_writer_done = false;
+   i_ret_val = pthread_create (&(px_ckpt_ctxt->x_writer_thread), NULL,
+      checkpoint_writer_thread, px_ckpt_ctxt);
+   if (0 != i_ret_val)
+   {
+      e_checkpoint_ret = checkpoint_save (&(px_ckpt_ctxt->x_snapshot),
+         px_ckpt_ctxt->pc_path);
+      if (eCHECKPOINT_RET_SUCCESS != e_checkpoint_ret)
+      {
+         printf ("Checkpoint \"%s\" could not be written\n",
+            px_ckpt_ctxt->pc_path);
+      }
+      goto LBL_CLEANUP;
+   }
+   px_ckpt_ctxt->b_writer_running = true;
+LBL_CLEANUP:
+   return;
+}
+
+/*
+ * Returns 0 on success, including when there is no checkpoint to resume from.
+ */
+static int checkpoint_resume (
+   CLI_CTXT_X *px_tok_ctxt,
+   CHECKPOINT_CTXT_X *px_ckpt_ctxt)
+{
+   int i_ret_val = -1;
+   CHECKPOINT_RET_E e_checkpoint_ret = eCHECKPOINT_RET_FAILURE;
+   CHECKPOINT_HEADER_X x_header = {NULL};
+   TOKENIZER_STATS_X x_tok_stats = {0};
+
+   px_ckpt_ctxt->px_tok_ctxt = px_tok_ctxt;
+
+   /*
+    * The token records are added to the table as they are read. A bad
+    * checkpoint is therefore fatal rather than a reason to start afresh.
+    */
+   e_checkpoint_ret = checkpoint_load (px_ckpt_ctxt->pc_path, &x_header,
+      fn_checkpoint_token_cbk, fn_checkpoint_file_cbk, px_ckpt_ctxt);
+   if (eCHECKPOINT_RET_FILE_NOT_FOUND == e_checkpoint_ret)
+   {
+      printf ("No checkpoint \"%s\", starting afresh\n", px_ckpt_ctxt->pc_path);
+      i_ret_val = 0;
+      goto LBL_CLEANUP;
+   }
+   if (eCHECKPOINT_RET_SUCCESS != e_checkpoint_ret)
+   {
+      printf ("Checkpoint \"%s\" could not be read: %d\n",
+         px_ckpt_ctxt->pc_path, e_checkpoint_ret);
+      goto LBL_CLEANUP;
+   }
+
+   if (0 != strcmp (x_header.pc_root_dir, px_ckpt_ctxt->pc_root_dir))
+   {
+      printf ("Checkpoint \"%s\" is for directory \"%s\"\n",
+         px_ckpt_ctxt->pc_path, x_header.pc_root_dir);
+      goto LBL_CLEANUP;
+   }
+
+   /*
+    * The token records add up to the total token count of the run.
+    */
+   if ((eTOKENIZER_RET_SUCCESS != tokenizer_get_stats (
+         px_tok_ctxt->hl_tokenizer_hdl, &x_tok_stats))
+      || (x_tok_stats.ui64_num_tokens != x_header.ui64_num_tokens))
+   {
+      printf ("Checkpoint \"%s\" is inconsistent\n", px_ckpt_ctxt->pc_path);
+      goto LBL_CLEANUP;
+   }
+
+   /*
+    * Sized by the number of file records rather than by the token table, so
+    * the lookup stays O(log n) however many files the checkpoint holds.
+    */
+   if (px_ckpt_ctxt->ui_num_done_files > 0)
+   {
+      px_ckpt_ctxt->ppc_resumed_files = pal_malloc (
+         px_ckpt_ctxt->ui_num_done_files * sizeof(char *), NULL);
+      if (NULL == px_ckpt_ctxt->ppc_resumed_files)
+      {
+         goto LBL_CLEANUP;
+      }
+      (void) pal_memmove (px_ckpt_ctxt->ppc_resumed_files,
+         px_ckpt_ctxt->ppc_done_files,
+         px_ckpt_ctxt->ui_num_done_files * sizeof(char *));
+      px_ckpt_ctxt->ui_num_resumed_files = px_ckpt_ctxt->ui_num_done_files;
+      qsort (px_ckpt_ctxt->ppc_resumed_files,
+         px_ckpt_ctxt->ui_num_resumed_files, sizeof(char *),
+         fn_done_file_compare_cbk);
+   }
+
+   px_tok_ctxt->ui_num_docs = x_header.ui_num_docs;
+   px_tok_ctxt->ui64_resumed_hot_cache_hits = x_header.ui64_hot_cache_hits;
+   px_tok_ctxt->ui64_resumed_hot_cache_lookups =
+      x_header.ui64_hot_cache_lookups;
+   printf ("Resuming from checkpoint \"%s\": %d files done\n",
+      px_ckpt_ctxt->pc_path, px_ckpt_ctxt->ui_num_done_files);
+   i_ret_val = 0;
+LBL_CLEANUP:
+   if (NULL != x_header.pc_root_dir)
+   {
+      pal_free (x_header.pc_root_dir);
+   }
+   return i_ret_val;
 }
 
 static void print_usage(
@@ -554,11 +1045,38 @@ static void print_usage(
    char **ppc_argv)
 {
    printf ("\n Usage:"
-      "\n \t%s <Directory To Parse> [<Hashmap Table Size (Default: %d)>]"
+      "\n \t%s [<Options>] <Directory To Parse> [<Hashmap Table Size (Default: %d)>]"
       "\n \t\tDirectory To Parse - Absolute or relative directory path to parse files."
+      "\n \t\t                     The directory is walked recursively."
       "\n \t\tHashmap Table Size - Table size of the hashmap. Smaller the table "
-      "size slower is the run time. [Optional: Default: %d]",
-      ppc_argv[0], DEFAULT_HASHMAP_TABLE_SIZE, DEFAULT_HASHMAP_TABLE_SIZE);
+      "size slower is the run time. [Optional: Default: %d]"
+      "\n \tOptions:"
+      "\n \t\t-t, --threads <Threads>          - Number of directory traversal "
+      "threads. [Default: %d]"
+      "\n \t\t-i, --include <Glob>             - Only parse files matching the "
+      "glob. Can be repeated."
+      "\n \t\t-x, --exclude <Glob>             - Skip files and directories "
+      "matching the glob. Can be repeated."
+      "\n \t\t-l, --symlinks <skip|files|all>  - Symbolic link policy. "
+      "[Default: skip]"
+      "\n \t\t-s, --sort                       - Parse the files in sorted "
+      "order."
+      "\n \t\t-c, --hot-cache <Entries>        - Number of entries in the hot "
+      "token cache, a power of 2. 0 disables the cache. [Default: %d]"
+      "\n \t\t-k, --checkpoint <File>          - Periodically save a "
+      "checkpoint to the file."
+      "\n \t\t-n, --checkpoint-files <Files>   - Save a checkpoint every "
+      "given number of files."
+      "\n \t\t-T, --checkpoint-interval <Secs> - Save a checkpoint every "
+      "given number of seconds. [Default: %d if -n is not given]"
+      "\n \t\t-r, --resume                     - Resume from the checkpoint "
+      "given with -k, if it exists."
+      "\n \t\t-p, --file-stats <Files>         - Print per file read and "
+      "tokenize latency and size percentiles and the given number of slowest "
+      "files. [Max: %d]",
+      ppc_argv[0], DEFAULT_HASHMAP_TABLE_SIZE, DEFAULT_HASHMAP_TABLE_SIZE,
+      WALKER_DEFAULT_NUM_THREADS, DEFAULT_HOT_CACHE_SIZE,
+      DEFAULT_CHECKPOINT_INTERVAL_SEC, FILE_STATS_MAX_NUM_SLOWEST);
    printf ("\n");
 }
 
@@ -567,12 +1085,19 @@ int main(
    char **ppc_argv)
 {
    int i_ret_val = -1;
-   DIR *p_dir = NULL;
-   struct dirent *px_dirent = NULL;
-   char ca_filename[MAX_FILENAME_LEN] = {0};
-   TOKENIZER_CTXT_X x_tok_ctxt = {NULL};
-   HM_RET_E e_hm_ret = eHM_RET_FAILURE;
-   HM_INIT_PARAMS_X x_hm_init_params = {0};
+   int i_opt = -1;
+   char *pc_dir_to_parse = NULL;
+   char *pc_filename = NULL;
+   char *pca_include_globs[MAX_GLOBS] = {NULL};
+   char *pca_exclude_globs[MAX_GLOBS] = {NULL};
+   WALKER_HDL hl_walker_hdl = NULL;
+   WALKER_RET_E e_walker_ret = eWALKER_RET_FAILURE;
+   WALKER_INIT_PARAMS_X x_walker_init_params = {NULL};
+   WALKER_STATS_X x_walker_stats = {0};
+   CLI_CTXT_X x_tok_ctxt = {NULL};
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_FAILURE;
+   TOKENIZER_INIT_PARAMS_X x_tok_init_params = {0};
+   TOKENIZER_STATS_X x_tok_stats = {0};
    LIST_RET_E e_list_ret = eLIST_RET_FAILURE;
    LIST_INIT_PARAMS_X x_init_params = {0};
    uint32_t ui_start_time_ms = 0;
@@ -582,81 +1107,354 @@ int main(
    LIST_NODE_DATA_X x_list_node_data = {0};
    TOKEN_STATS_X *px_list_node_data = NULL;
    PAL_RET_E e_pal_ret = ePAL_RET_FAILURE;
+   CHECKPOINT_CTXT_X x_ckpt_ctxt = {NULL};
+   uint32_t ui_checkpoint_interval_sec = 0;
+   bool b_resume = false;
+   bool b_file_stats = false;
+   uint32_t ui_num_slowest = FILE_STATS_DEFAULT_NUM_SLOWEST;
+#ifdef ENABLE_FILE_STATS
+   FILE_STATS_SAMPLE_X x_file_sample = {0};
+   bool b_parsed = false;
+#endif
+   FILE_STATS_SAMPLE_X *px_file_sample = NULL;
+   uint32_t ui_i = 0;
+   static const struct option xa_long_options[] =
+   {
+      {"threads",             required_argument, NULL, 't'},
+      {"include",             required_argument, NULL, 'i'},
+      {"exclude",             required_argument, NULL, 'x'},
+      {"symlinks",            required_argument, NULL, 'l'},
+      {"sort",                no_argument,       NULL, 's'},
+      {"hot-cache",           required_argument, NULL, 'c'},
+      {"checkpoint",          required_argument, NULL, 'k'},
+      {"checkpoint-files",    required_argument, NULL, 'n'},
+      {"checkpoint-interval", required_argument, NULL, 'T'},
+      {"resume",              no_argument,       NULL, 'r'},
+      {"file-stats",          required_argument, NULL, 'p'},
+      {NULL,                  0,                 NULL, 0}
+   };
+
+   (void) pthread_mutex_init (&(x_ckpt_ctxt.x_writer_mutex), NULL);
+
+   x_tok_init_params.ui_hot_cache_size = DEFAULT_HOT_CACHE_SIZE;
+
+   x_walker_init_params.ppc_include_globs = pca_include_globs;
+   x_walker_init_params.ppc_exclude_globs = pca_exclude_globs;
+   x_walker_init_params.e_symlink_policy = eWALKER_SYMLINK_POLICY_SKIP;
+
+   while ((i_opt = getopt_long (i_argc, ppc_argv, "t:i:x:l:sc:k:n:T:rp:",
+         xa_long_options, NULL)) != -1)
+   {
+      switch (i_opt)
+      {
+         case 't':
+         {
+            e_pal_ret = pal_atoi((uint8_t *) optarg,
+               (int32_t *) &(x_walker_init_params.ui_num_threads));
+            if (ePAL_RET_SUCCESS != e_pal_ret)
+            {
+               print_usage (i_argc, ppc_argv);
+               goto LBL_CLEANUP;
+            }
+            break;
+         }
+         case 'i':
+         {
+            if (x_walker_init_params.ui_num_include_globs >= MAX_GLOBS)
+            {
+               printf ("Too many include globs. Max: %d\n", MAX_GLOBS);
+               goto LBL_CLEANUP;
+            }
+            pca_include_globs[x_walker_init_params.ui_num_include_globs++] =
+               optarg;
+            break;
+         }
+         case 'x':
+         {
+            if (x_walker_init_params.ui_num_exclude_globs >= MAX_GLOBS)
+            {
+               printf ("Too many exclude globs. Max: %d\n", MAX_GLOBS);
+               goto LBL_CLEANUP;
+            }
+            pca_exclude_globs[x_walker_init_params.ui_num_exclude_globs++] =
+               optarg;
+            break;
+         }
+         case 'l':
+         {
+            if (0 == strcmp (optarg, "skip"))
+            {
+               x_walker_init_params.e_symlink_policy =
+                  eWALKER_SYMLINK_POLICY_SKIP;
+            }
+            else if (0 == strcmp (optarg, "files"))
+            {
+               x_walker_init_params.e_symlink_policy =
+                  eWALKER_SYMLINK_POLICY_FOLLOW_FILES;
+            }
+            else if (0 == strcmp (optarg, "all"))
+            {
+               x_walker_init_params.e_symlink_policy =
+                  eWALKER_SYMLINK_POLICY_FOLLOW_ALL;
+            }
+            else
+            {
+               print_usage (i_argc, ppc_argv);
+               goto LBL_CLEANUP;
+            }
+            break;
+         }
+         case 's':
+         {
+            x_walker_init_params.b_sort_files = true;
+            break;
+         }
+         case 'c':
+         {
+            e_pal_ret = pal_atoi((uint8_t *) optarg,
+               (int32_t *) &(x_tok_init_params.ui_hot_cache_size));
+            if ((ePAL_RET_SUCCESS != e_pal_ret)
+               || (x_tok_init_params.ui_hot_cache_size >
+                  TOKENIZER_MAX_HOT_CACHE_SIZE)
+               || (0 != (x_tok_init_params.ui_hot_cache_size &
+                  (x_tok_init_params.ui_hot_cache_size - 1))))
+            {
+               print_usage (i_argc, ppc_argv);
+               goto LBL_CLEANUP;
+            }
+            break;
+         }
+         case 'k':
+         {
+            x_ckpt_ctxt.pc_path = optarg;
+            break;
+         }
+         case 'n':
+         {
+            e_pal_ret = pal_atoi((uint8_t *) optarg,
+               (int32_t *) &(x_ckpt_ctxt.ui_interval_files));
+            if (ePAL_RET_SUCCESS != e_pal_ret)
+            {
+               print_usage (i_argc, ppc_argv);
+               goto LBL_CLEANUP;
+            }
+            break;
+         }
+         case 'T':
+         {
+            e_pal_ret = pal_atoi((uint8_t *) optarg,
+               (int32_t *) &ui_checkpoint_interval_sec);
+            if (ePAL_RET_SUCCESS != e_pal_ret)
+            {
+               print_usage (i_argc, ppc_argv);
+               goto LBL_CLEANUP;
+            }
+            break;
+         }
+         case 'r':
+         {
+            b_resume = true;
+            break;
+         }
+         case 'p':
+         {
+            e_pal_ret = pal_atoi((uint8_t *) optarg,
+               (int32_t *) &ui_num_slowest);
+            if ((ePAL_RET_SUCCESS != e_pal_ret)
+               || (ui_num_slowest > FILE_STATS_MAX_NUM_SLOWEST))
+            {
+               print_usage (i_argc, ppc_argv);
+               goto LBL_CLEANUP;
+            }
+            b_file_stats = true;
+            break;
+         }
+         default:
+         {
+            print_usage (i_argc, ppc_argv);
+            goto LBL_CLEANUP;
+         }
+      }
+   }
 
-   if (i_argc < 2 || i_argc > 3)
+   if ((i_argc - optind) < 1 || (i_argc - optind) > 2)
    {
       print_usage (i_argc, ppc_argv);
       i_ret_val = -1;
       goto LBL_CLEANUP;
    }
 
+   if ((true == b_resume) && (NULL == x_ckpt_ctxt.pc_path))
+   {
+      printf ("--resume requires --checkpoint\n");
+      print_usage (i_argc, ppc_argv);
+      i_ret_val = -1;
+      goto LBL_CLEANUP;
+   }
+
+   if ((NULL != x_ckpt_ctxt.pc_path) && (0 == x_ckpt_ctxt.ui_interval_files)
+      && (0 == ui_checkpoint_interval_sec))
+   {
+      ui_checkpoint_interval_sec = DEFAULT_CHECKPOINT_INTERVAL_SEC;
+   }
+   x_ckpt_ctxt.ui_interval_ms = ui_checkpoint_interval_sec * 1000;
+
    pal_env_init ();
 
-   if (NULL != ppc_argv[2])
+   pc_dir_to_parse = ppc_argv [optind];
+   if ((i_argc - optind) > 1)
    {
-      e_pal_ret = pal_atoi((uint8_t *) ppc_argv[2],
-         (int32_t *) &(x_hm_init_params.ui_hm_table_size));
+      e_pal_ret = pal_atoi((uint8_t *) ppc_argv[optind + 1],
+         (int32_t *) &(x_tok_init_params.ui_hm_table_size));
       if (ePAL_RET_SUCCESS != e_pal_ret)
       {
-         x_hm_init_params.ui_hm_table_size = DEFAULT_HASHMAP_TABLE_SIZE;
+         x_tok_init_params.ui_hm_table_size = DEFAULT_HASHMAP_TABLE_SIZE;
       }
    }
    else
    {
-      x_hm_init_params.ui_hm_table_size = DEFAULT_HASHMAP_TABLE_SIZE;
+      x_tok_init_params.ui_hm_table_size = DEFAULT_HASHMAP_TABLE_SIZE;
    }
 
+   e_tok_ret = tokenizer_create (&(x_tok_ctxt.hl_tokenizer_hdl),
+      &x_tok_init_params);
+   if (eTOKENIZER_RET_SUCCESS != e_tok_ret)
+   {
+      printf ("tokenizer_create failed: %d\n", e_tok_ret);
+      i_ret_val = -1;
+      goto LBL_CLEANUP;
+   }
 
-   x_hm_init_params.e_hm_key_type = eHM_KEY_TYPE_STRING;
-   e_hm_ret = hm_create(&(x_tok_ctxt.hl_token_hm), &x_hm_init_params);
-   if (eHM_RET_SUCCESS != e_hm_ret)
+   x_tok_ctxt.pc_read_buf = pal_malloc (READ_BUFFER_SIZE, NULL);
+   if (NULL == x_tok_ctxt.pc_read_buf)
    {
       i_ret_val = -1;
       goto LBL_CLEANUP;
    }
 
-   if (NULL == ppc_argv [1])
+   if (true == b_file_stats)
    {
-      p_dir = opendir ((const char *) DEFAULT_DIRECTORY_TO_PARSE);
+#ifdef ENABLE_FILE_STATS
+      if (eFILE_STATS_RET_SUCCESS != file_stats_create (
+            &(x_tok_ctxt.hl_file_stats_hdl), ui_num_slowest))
+      {
+         printf ("file_stats_create failed\n");
+         i_ret_val = -1;
+         goto LBL_CLEANUP;
+      }
+      px_file_sample = &x_file_sample;
+#else
+      printf ("--file-stats is not available, it was compiled out with "
+         "--disable-file-stats\n");
+      i_ret_val = -1;
+      goto LBL_CLEANUP;
+#endif
    }
-   else
+
+   x_ckpt_ctxt.pc_root_dir = pc_dir_to_parse;
+   if (true == b_resume)
    {
-      p_dir = opendir ((const char *) ppc_argv [1]);
+      i_ret_val = checkpoint_resume (&x_tok_ctxt, &x_ckpt_ctxt);
+      if (0 != i_ret_val)
+      {
+         goto LBL_CLEANUP;
+      }
    }
+
    ui_start_time_ms = pal_get_system_time_ms();
-   if (NULL != p_dir)
-   {
+   x_ckpt_ctxt.ui_last_time_ms = ui_start_time_ms;
 
-      while ((px_dirent = readdir (p_dir)) != NULL)
+   x_walker_init_params.pc_root_dir = pc_dir_to_parse;
+   e_walker_ret = walker_create (&hl_walker_hdl, &x_walker_init_params);
+   if (eWALKER_RET_SUCCESS != e_walker_ret)
+   {
+      printf ("walker_create failed for \"%s\": %d\n", pc_dir_to_parse,
+         e_walker_ret);
+   }
+   else
+   {
+      /*
+       * Files are tokenized as and when the walker threads discover them.
+       */
+      while (1)
       {
-         if (8 == px_dirent->d_type)
+         e_walker_ret = walker_get_next_file (hl_walker_hdl, &pc_filename);
+         if (eWALKER_RET_SUCCESS != e_walker_ret)
          {
-            (void) pal_memset(ca_filename, 0x00, sizeof(ca_filename));
+            break;
+         }
 
-            if (NULL == ppc_argv [1])
-            {
-               snprintf (ca_filename, sizeof(ca_filename), "%s/%s",
-                  DEFAULT_DIRECTORY_TO_PARSE, px_dirent->d_name);
-            }
-            else
-            {
-               snprintf (ca_filename, sizeof(ca_filename), "%s/%s",
-                  (const char *) ppc_argv [1], px_dirent->d_name);
-            }
+         if (true == checkpoint_is_file_done (&x_ckpt_ctxt, pc_filename))
+         {
+            pal_free (pc_filename);
+            pc_filename = NULL;
+            continue;
+         }
+
+#ifdef ENABLE_FILE_STATS
+         if (NULL != px_file_sample)
+         {
+            file_stats_sample_start (px_file_sample);
+         }
+         b_parsed = parse_file (&x_tok_ctxt, pc_filename, px_file_sample);
+         /*
+          * A file which could not be read completely would add a bogus
+          * sample, e.g. 0 bytes in 0 us.
+          */
+         if ((NULL != px_file_sample) && (true == b_parsed))
+         {
+            (void) file_stats_add (x_tok_ctxt.hl_file_stats_hdl, pc_filename,
+               px_file_sample);
+         }
+#else
+         (void) parse_file (&x_tok_ctxt, pc_filename, px_file_sample);
+#endif
+         x_tok_ctxt.ui_num_docs++;
 
-            parse_file (&x_tok_ctxt, ca_filename);
+         if (NULL == x_ckpt_ctxt.pc_path)
+         {
+            pal_free (pc_filename);
+            pc_filename = NULL;
+            continue;
+         }
+
+         if (false == checkpoint_add_done_file (&x_ckpt_ctxt, pc_filename))
+         {
+            pal_free (pc_filename);
+         }
+         pc_filename = NULL;
+
+         x_ckpt_ctxt.ui_files_since_last++;
+         if (((x_ckpt_ctxt.ui_interval_files > 0) &&
+               (x_ckpt_ctxt.ui_files_since_last >=
+                  x_ckpt_ctxt.ui_interval_files)) ||
+            ((x_ckpt_ctxt.ui_interval_ms > 0) &&
+               ((pal_get_system_time_ms () - x_ckpt_ctxt.ui_last_time_ms) >=
+                  x_ckpt_ctxt.ui_interval_ms)))
+         {
+            checkpoint_take (&x_tok_ctxt, &x_ckpt_ctxt);
          }
       }
 
-      (void) closedir (p_dir);
+      (void) walker_get_stats (hl_walker_hdl, &x_walker_stats);
+      (void) walker_delete (hl_walker_hdl);
+      hl_walker_hdl = NULL;
    }
 
+   checkpoint_reap_writer (&x_ckpt_ctxt, true);
+
+   e_tok_ret = tokenizer_get_stats (x_tok_ctxt.hl_tokenizer_hdl, &x_tok_stats);
+
    ui_end_time_ms = pal_get_system_time_ms();
    ui_diff_time_tokenization_ms = ui_end_time_ms - ui_start_time_ms;
 
-   e_hm_ret = hm_get_total_count(x_tok_ctxt.hl_token_hm, &(x_tok_ctxt.ui_num_unique_tokens));
+   x_tok_ctxt.ui_num_unique_tokens = x_tok_stats.ui_num_unique_tokens;
+   x_tok_ctxt.ui64_num_tokens = x_tok_stats.ui64_num_tokens;
 
-   x_init_params.ui_list_max_elements = x_tok_ctxt.ui_num_tokens;
+   /*
+    * The list holds one node per unique token.
+    */
+   x_init_params.ui_list_max_elements = x_tok_ctxt.ui_num_unique_tokens;
    e_list_ret = list_create(&(x_tok_ctxt.hl_token_list), &x_init_params);
    if ((eLIST_RET_SUCCESS != e_list_ret) || (NULL == x_tok_ctxt.hl_token_list))
    {
@@ -670,10 +1468,11 @@ int main(
             "Token", "Occurances","Frequency");
    printf ("|-%7s-+-%20s-+-%10s-+-%7s|\n", "-------",
                "--------------------", "----------","---------");
-   e_hm_ret = hm_for_each(x_tok_ctxt.hl_token_hm, fn_hm_for_each_cbk, &x_tok_ctxt);
-   if (eHM_RET_SUCCESS != e_hm_ret)
+   e_tok_ret = tokenizer_for_each_token (x_tok_ctxt.hl_tokenizer_hdl,
+      fn_tokenizer_for_each_cbk, &x_tok_ctxt);
+   if (eTOKENIZER_RET_SUCCESS != e_tok_ret)
    {
-      printf ("hm_for_each failed: %d\n", e_hm_ret);
+      printf ("tokenizer_for_each_token failed: %d\n", e_tok_ret);
    }
 
    e_list_ret = list_for_all_nodes (x_tok_ctxt.hl_token_list,
@@ -698,25 +1497,37 @@ int main(
                   "--------------------", "----------","---------");
 
    printf ("\n\nTotal Unique Tokens: %d\n", x_tok_ctxt.ui_num_unique_tokens);
-   printf ("\nTotal Tokens: %d\n", x_tok_ctxt.ui_num_tokens);
+   printf ("\nTotal Tokens: %llu\n",
+      (unsigned long long) x_tok_ctxt.ui64_num_tokens);
    printf ("\nTokens Occuring Only Once: %d\n", x_tok_ctxt.ui_one_occur_token);
+   if (x_walker_stats.ui_num_skipped_dirs > 0)
+   {
+      printf ("\nDirectories Skipped: %d (see stderr)\n",
+         x_walker_stats.ui_num_skipped_dirs);
+   }
+   x_tok_stats.ui64_hot_cache_hits += x_tok_ctxt.ui64_resumed_hot_cache_hits;
+   x_tok_stats.ui64_hot_cache_lookups +=
+      x_tok_ctxt.ui64_resumed_hot_cache_lookups;
+   if (x_tok_stats.ui64_hot_cache_lookups > 0)
+   {
+      printf ("\nHot Token Cache Hit Rate: %.2lf%% (%llu of %llu tokens)\n",
+         (((double) x_tok_stats.ui64_hot_cache_hits /
+            (double) x_tok_ctxt.ui64_num_tokens) * (double) 100),
+         (unsigned long long) x_tok_stats.ui64_hot_cache_hits,
+         (unsigned long long) x_tok_ctxt.ui64_num_tokens);
+   }
    printf ("\nTime Taken for Tokenization: %d ms\n", ui_diff_time_tokenization_ms);
    printf ("\nTotal Time Taken: %d ms\n", ui_diff_time_ms);
+#ifdef ENABLE_FILE_STATS
+   if (NULL != x_tok_ctxt.hl_file_stats_hdl)
+   {
+      file_stats_print (x_tok_ctxt.hl_file_stats_hdl);
+   }
+#endif
 
    /*
     * Do cleanup
     */
-   // Clean up all the hash map items by iterating through the keys in the list.
-   e_list_ret = list_for_all_nodes (x_tok_ctxt.hl_token_list,
-      fn_list_for_all_delete_cbk, &x_tok_ctxt);
-   if (eLIST_RET_SUCCESS != e_list_ret)
-   {
-      if (eLIST_RET_LIST_EMPTY == e_list_ret)
-      {
-         printf ("List Empty\n");
-      }
-   }
-
    // Cleanup elements in the list.
    while (1)
    {
@@ -744,7 +1555,39 @@ int main(
 
    // Cleanup data structures.
    list_delete(x_tok_ctxt.hl_token_list);
-   hm_delete(x_tok_ctxt.hl_token_hm);
+   tokenizer_delete (x_tok_ctxt.hl_tokenizer_hdl);
+   pal_free (x_tok_ctxt.pc_read_buf);
+#ifdef ENABLE_FILE_STATS
+   if (NULL != x_tok_ctxt.hl_file_stats_hdl)
+   {
+      file_stats_delete (x_tok_ctxt.hl_file_stats_hdl);
+   }
+#endif
+   if (NULL != x_ckpt_ctxt.ppc_resumed_files)
+   {
+      pal_free (x_ckpt_ctxt.ppc_resumed_files);
+   }
+   for (ui_i = 0; ui_i < x_ckpt_ctxt.ui_num_done_files; ui_i++)
+   {
+      pal_free (x_ckpt_ctxt.ppc_done_files[ui_i]);
+   }
+   if (NULL != x_ckpt_ctxt.ppc_done_files)
+   {
+      pal_free (x_ckpt_ctxt.ppc_done_files);
+   }
+   if (NULL != x_ckpt_ctxt.x_snapshot.pc_tokens)
+   {
+      pal_free (x_ckpt_ctxt.x_snapshot.pc_tokens);
+   }
+   if (NULL != x_ckpt_ctxt.x_snapshot.px_records)
+   {
+      pal_free (x_ckpt_ctxt.x_snapshot.px_records);
+   }
+   if (NULL != x_ckpt_ctxt.x_snapshot.ppc_done_files)
+   {
+      pal_free (x_ckpt_ctxt.x_snapshot.ppc_done_files);
+   }
+   (void) pthread_mutex_destroy (&(x_ckpt_ctxt.x_writer_mutex));
    pal_env_deinit ();
    i_ret_val = 0;
 
@@ -0,0 +1,999 @@
+/*******************************************************************************
+ * Copyright (c) 2026, agent <agent@local>
+ *
+ * \file   ch-ir-walker.c
+ *
+ * \author agent
+ *
+ * \date   Oct 18, 2026
+ *
+ * \brief  Parallel directory tree walker.
+ *
+ * The directories yet to be read are kept on a shared stack which is drained
+ * by a pool of threads. Each directory is read through its own descriptor and
+ * its entries are resolved with fstatat/openat relative to it, so the kernel
+ * never has to walk the full path again. readdir may report DT_UNKNOWN (XFS,
+ * NFS, ...), in which case the type is taken from fstatat. Sub-directories are
+ * opened by the thread which discovered them and the descriptor is handed over
+ * along with the stack entry, up to half of RLIMIT_NOFILE descriptors. Beyond
+ * that, or when the process runs out of descriptors (EMFILE/ENFILE), only the
+ * path is queued and the directory is re-opened when it is picked up. Any
+ * other directory which cannot be read is reported on stderr and counted in
+ * the walker statistics.
+ *
+ * The regular files found are appended to a queue which is consumed by
+ * walker_get_next_file while the traversal is still going on.
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ch-ir-walker.h"
+
+#define WALKER_DEFAULT_MAX_QUEUED_FDS  (512)
+#define WALKER_FILE_BATCH_SIZE         (64)
+
+typedef struct _WALKER_DIR_ID_X
+{
+   dev_t x_dev;
+
+   ino_t x_ino;
+} WALKER_DIR_ID_X;
+
+typedef struct _WALKER_DIR_X
+{
+   struct _WALKER_DIR_X *px_next;
+
+   char *pc_path;
+
+   /*
+    * Descriptor opened by the thread which discovered the directory. -1 if
+    * the directory has to be opened using pc_path.
+    */
+   int i_fd;
+
+   /*
+    * Identity of the directory itself and of all its parents. Only
+    * maintained with eWALKER_SYMLINK_POLICY_FOLLOW_ALL to detect directory
+    * loops.
+    */
+   WALKER_DIR_ID_X x_id;
+
+   WALKER_DIR_ID_X *px_ancestors;
+
+   uint32_t ui_num_ancestors;
+} WALKER_DIR_X;
+
+typedef struct _WALKER_FILE_X
+{
+   struct _WALKER_FILE_X *px_next;
+
+   char *pc_path;
+} WALKER_FILE_X;
+
+typedef struct _WALKER_FILE_BATCH_X
+{
+   WALKER_FILE_X *px_head;
+
+   WALKER_FILE_X *px_tail;
+
+   uint32_t ui_count;
+} WALKER_FILE_BATCH_X;
+
+typedef struct _WALKER_CTXT_X
+{
+   WALKER_INIT_PARAMS_X x_init_params;
+
+   uint32_t ui_root_len;
+
+   pthread_t *px_threads;
+
+   uint32_t ui_num_threads;
+
+   /*
+    * Directory stack. ui_pending_dirs counts the directories on the stack as
+    * well as the ones being read. The walk is complete when it drops to 0.
+    */
+   pthread_mutex_t x_dir_mutex;
+
+   pthread_cond_t x_dir_cond;
+
+   WALKER_DIR_X *px_dir_stack;
+
+   uint32_t ui_pending_dirs;
+
+   uint32_t ui_queued_fds;
+
+   /*
+    * Number of descriptors which may be queued along with the directories,
+    * half of RLIMIT_NOFILE. The rest is left to the walker threads and to
+    * the application.
+    */
+   uint32_t ui_max_queued_fds;
+
+   uint32_t ui_num_skipped_dirs;
+
+   bool b_stop;
+
+   /*
+    * Queue of discovered files.
+    */
+   pthread_mutex_t x_file_mutex;
+
+   pthread_cond_t x_file_cond;
+
+   WALKER_FILE_BATCH_X x_files;
+
+   bool b_walk_complete;
+
+   /*
+    * Used only with b_sort_files. Populated on the first call to
+    * walker_get_next_file after the walk is complete.
+    */
+   char **ppc_sorted_files;
+
+   uint32_t ui_num_sorted_files;
+
+   uint32_t ui_next_sorted_file;
+} WALKER_CTXT_X;
+
+static void walker_free_dir (
+   WALKER_DIR_X *px_dir);
+
+static void walker_skip_dir (
+   WALKER_CTXT_X *px_walker_ctxt,
+   char *pc_path,
+   int i_errno);
+
+static uint32_t walker_get_max_queued_fds (
+   void);
+
+static WALKER_RET_E walker_push_dir (
+   WALKER_CTXT_X *px_walker_ctxt,
+   WALKER_DIR_X *px_parent,
+   char *pc_path,
+   int i_fd);
+
+static bool walker_does_glob_match (
+   WALKER_CTXT_X *px_walker_ctxt,
+   char **ppc_globs,
+   uint32_t ui_num_globs,
+   char *pc_path,
+   char *pc_name);
+
+static void walker_flush_files (
+   WALKER_CTXT_X *px_walker_ctxt,
+   WALKER_FILE_BATCH_X *px_batch);
+
+static void walker_process_dir (
+   WALKER_CTXT_X *px_walker_ctxt,
+   WALKER_DIR_X *px_dir);
+
+static void *walker_thread (
+   void *p_thread_args);
+
+static int walker_compare_filenames (
+   const void *p_a,
+   const void *p_b);
+
+static WALKER_RET_E walker_sort_files (
+   WALKER_CTXT_X *px_walker_ctxt);
+
+static void walker_free_dir (
+   WALKER_DIR_X *px_dir)
+{
+   if (NULL == px_dir)
+   {
+      goto LBL_CLEANUP;
+   }
+
+   if (-1 != px_dir->i_fd)
+   {
+      (void) close (px_dir->i_fd);
+   }
+
+   if (NULL != px_dir->px_ancestors)
+   {
+      pal_free (px_dir->px_ancestors);
+      px_dir->px_ancestors = NULL;
+   }
+
+   if (NULL != px_dir->pc_path)
+   {
+      pal_free (px_dir->pc_path);
+      px_dir->pc_path = NULL;
+   }
+
+   pal_free (px_dir);
+
+LBL_CLEANUP:
+   return;
+}
+
+/*
+ * Reports a directory whose contents will not be tokenized.
+ */
+static void walker_skip_dir (
+   WALKER_CTXT_X *px_walker_ctxt,
+   char *pc_path,
+   int i_errno)
+{
+   fprintf (stderr, "Skipping directory \"%s\": %s\n", pc_path,
+      strerror (i_errno));
+
+   (void) pthread_mutex_lock (&(px_walker_ctxt->x_dir_mutex));
+   px_walker_ctxt->ui_num_skipped_dirs++;
+   (void) pthread_mutex_unlock (&(px_walker_ctxt->x_dir_mutex));
+}
+
+static uint32_t walker_get_max_queued_fds (
+   void)
+{
+   struct rlimit x_rlimit = {0};
+
+   if ((0 != getrlimit (RLIMIT_NOFILE, &x_rlimit))
+      || (RLIM_INFINITY == x_rlimit.rlim_cur))
+   {
+      return WALKER_DEFAULT_MAX_QUEUED_FDS;
+   }
+
+   if ((x_rlimit.rlim_cur / 2) > UINT32_MAX)
+   {
+      return UINT32_MAX;
+   }
+   return (uint32_t) (x_rlimit.rlim_cur / 2);
+}
+
+/*
+ * Takes ownership of pc_path and i_fd. px_parent is NULL for the root.
+ */
+static WALKER_RET_E walker_push_dir (
+   WALKER_CTXT_X *px_walker_ctxt,
+   WALKER_DIR_X *px_parent,
+   char *pc_path,
+   int i_fd)
+{
+   WALKER_RET_E e_walker_ret = eWALKER_RET_FAILURE;
+   WALKER_DIR_X *px_dir = NULL;
+   uint32_t ui_num_ancestors = 0;
+   int i_fd_to_close = -1;
+
+   px_dir = pal_malloc (sizeof(WALKER_DIR_X), NULL);
+   if (NULL == px_dir)
+   {
+      e_walker_ret = eWALKER_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+   (void) pal_memset (px_dir, 0x00, sizeof(*px_dir));
+   px_dir->pc_path = pc_path;
+   px_dir->i_fd = i_fd;
+   pc_path = NULL;
+   i_fd = -1;
+
+   if ((eWALKER_SYMLINK_POLICY_FOLLOW_ALL ==
+         px_walker_ctxt->x_init_params.e_symlink_policy) && (NULL != px_parent))
+   {
+      ui_num_ancestors = px_parent->ui_num_ancestors + 1;
+      px_dir->px_ancestors = pal_malloc (
+         ui_num_ancestors * sizeof(WALKER_DIR_ID_X), NULL);
+      if (NULL == px_dir->px_ancestors)
+      {
+         e_walker_ret = eWALKER_RET_RESOURCE_FAILURE;
+         goto LBL_CLEANUP;
+      }
+      if (px_parent->ui_num_ancestors > 0)
+      {
+         (void) pal_memmove (px_dir->px_ancestors, px_parent->px_ancestors,
+            px_parent->ui_num_ancestors * sizeof(WALKER_DIR_ID_X));
+      }
+      px_dir->px_ancestors[ui_num_ancestors - 1] = px_parent->x_id;
+      px_dir->ui_num_ancestors = ui_num_ancestors;
+   }
+
+   (void) pthread_mutex_lock (&(px_walker_ctxt->x_dir_mutex));
+   if (-1 != px_dir->i_fd)
+   {
+      if (px_walker_ctxt->ui_queued_fds >= px_walker_ctxt->ui_max_queued_fds)
+      {
+         i_fd_to_close = px_dir->i_fd;
+         px_dir->i_fd = -1;
+      }
+      else
+      {
+         px_walker_ctxt->ui_queued_fds++;
+      }
+   }
+   px_dir->px_next = px_walker_ctxt->px_dir_stack;
+   px_walker_ctxt->px_dir_stack = px_dir;
+   px_walker_ctxt->ui_pending_dirs++;
+   (void) pthread_cond_signal (&(px_walker_ctxt->x_dir_cond));
+   (void) pthread_mutex_unlock (&(px_walker_ctxt->x_dir_mutex));
+   px_dir = NULL;
+
+   if (-1 != i_fd_to_close)
+   {
+      (void) close (i_fd_to_close);
+   }
+   e_walker_ret = eWALKER_RET_SUCCESS;
+LBL_CLEANUP:
+   if (NULL != pc_path)
+   {
+      pal_free (pc_path);
+   }
+   if (-1 != i_fd)
+   {
+      (void) close (i_fd);
+   }
+   walker_free_dir (px_dir);
+   return e_walker_ret;
+}
+
+static bool walker_does_glob_match (
+   WALKER_CTXT_X *px_walker_ctxt,
+   char **ppc_globs,
+   uint32_t ui_num_globs,
+   char *pc_path,
+   char *pc_name)
+{
+   bool b_match = false;
+   uint32_t ui_i = 0;
+   char *pc_rel_path = NULL;
+
+   pc_rel_path = pc_path + px_walker_ctxt->ui_root_len + 1;
+
+   for (ui_i = 0; ui_i < ui_num_globs; ui_i++)
+   {
+      if (NULL != strchr (ppc_globs[ui_i], '/'))
+      {
+         b_match = (0 == fnmatch (ppc_globs[ui_i], pc_rel_path,
+            FNM_PATHNAME));
+      }
+      else
+      {
+         b_match = (0 == fnmatch (ppc_globs[ui_i], pc_name, 0));
+      }
+
+      if (true == b_match)
+      {
+         break;
+      }
+   }
+
+   return b_match;
+}
+
+static void walker_flush_files (
+   WALKER_CTXT_X *px_walker_ctxt,
+   WALKER_FILE_BATCH_X *px_batch)
+{
+   if (0 == px_batch->ui_count)
+   {
+      goto LBL_CLEANUP;
+   }
+
+   (void) pthread_mutex_lock (&(px_walker_ctxt->x_file_mutex));
+   if (NULL == px_walker_ctxt->x_files.px_tail)
+   {
+      px_walker_ctxt->x_files.px_head = px_batch->px_head;
+   }
+   else
+   {
+      px_walker_ctxt->x_files.px_tail->px_next = px_batch->px_head;
+   }
+   px_walker_ctxt->x_files.px_tail = px_batch->px_tail;
+   px_walker_ctxt->x_files.ui_count += px_batch->ui_count;
+   (void) pthread_cond_broadcast (&(px_walker_ctxt->x_file_cond));
+   (void) pthread_mutex_unlock (&(px_walker_ctxt->x_file_mutex));
+
+   (void) pal_memset (px_batch, 0x00, sizeof(*px_batch));
+LBL_CLEANUP:
+   return;
+}
+
+static void walker_process_dir (
+   WALKER_CTXT_X *px_walker_ctxt,
+   WALKER_DIR_X *px_dir)
+{
+   WALKER_INIT_PARAMS_X *px_init_params = NULL;
+   DIR *p_dir = NULL;
+   struct dirent *px_dirent = NULL;
+   struct stat x_stat = {0};
+   int i_dir_fd = -1;
+   int i_child_fd = -1;
+   int i_open_flags = 0;
+   unsigned char uc_type = DT_UNKNOWN;
+   bool b_is_link = false;
+   uint32_t ui_i = 0;
+   uint32_t ui_path_len = 0;
+   uint32_t ui_name_len = 0;
+   char *pc_path = NULL;
+   WALKER_FILE_X *px_file = NULL;
+   WALKER_FILE_BATCH_X x_batch = {NULL};
+
+   px_init_params = &(px_walker_ctxt->x_init_params);
+
+   if (-1 == px_dir->i_fd)
+   {
+      px_dir->i_fd = open (px_dir->pc_path,
+         O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+      if (-1 == px_dir->i_fd)
+      {
+         walker_skip_dir (px_walker_ctxt, px_dir->pc_path, errno);
+         goto LBL_CLEANUP;
+      }
+   }
+
+   if (eWALKER_SYMLINK_POLICY_FOLLOW_ALL == px_init_params->e_symlink_policy)
+   {
+      /*
+       * A directory which is one of its own ancestors has been reached
+       * through a symbolic link loop.
+       */
+      if (0 != fstat (px_dir->i_fd, &x_stat))
+      {
+         walker_skip_dir (px_walker_ctxt, px_dir->pc_path, errno);
+         goto LBL_CLEANUP;
+      }
+      px_dir->x_id.x_dev = x_stat.st_dev;
+      px_dir->x_id.x_ino = x_stat.st_ino;
+      for (ui_i = 0; ui_i < px_dir->ui_num_ancestors; ui_i++)
+      {
+         if ((px_dir->px_ancestors[ui_i].x_dev == px_dir->x_id.x_dev) &&
+               (px_dir->px_ancestors[ui_i].x_ino == px_dir->x_id.x_ino))
+         {
+            goto LBL_CLEANUP;
+         }
+      }
+   }
+
+   /*
+    * The descriptor is owned by p_dir from here on.
+    */
+   i_dir_fd = px_dir->i_fd;
+   p_dir = fdopendir (i_dir_fd);
+   if (NULL == p_dir)
+   {
+      walker_skip_dir (px_walker_ctxt, px_dir->pc_path, errno);
+      goto LBL_CLEANUP;
+   }
+   px_dir->i_fd = -1;
+
+   ui_path_len = pal_strlen (px_dir->pc_path);
+
+   while ((px_dirent = readdir (p_dir)) != NULL)
+   {
+      if ((0 == strcmp (px_dirent->d_name, "."))
+         || (0 == strcmp (px_dirent->d_name, "..")))
+      {
+         continue;
+      }
+
+      uc_type = px_dirent->d_type;
+      b_is_link = false;
+
+      if (DT_UNKNOWN == uc_type)
+      {
+         if (0 != fstatat (i_dir_fd, px_dirent->d_name, &x_stat,
+               AT_SYMLINK_NOFOLLOW))
+         {
+            continue;
+         }
+         uc_type = S_ISREG(x_stat.st_mode) ? DT_REG :
+                   S_ISDIR(x_stat.st_mode) ? DT_DIR :
+                   S_ISLNK(x_stat.st_mode) ? DT_LNK : DT_UNKNOWN;
+      }
+
+      if (DT_LNK == uc_type)
+      {
+         if (eWALKER_SYMLINK_POLICY_SKIP == px_init_params->e_symlink_policy)
+         {
+            continue;
+         }
+         if (0 != fstatat (i_dir_fd, px_dirent->d_name, &x_stat, 0))
+         {
+            /*
+             * Dangling link.
+             */
+            continue;
+         }
+         uc_type = S_ISREG(x_stat.st_mode) ? DT_REG :
+                   S_ISDIR(x_stat.st_mode) ? DT_DIR : DT_UNKNOWN;
+         if ((DT_DIR == uc_type) && (eWALKER_SYMLINK_POLICY_FOLLOW_ALL !=
+               px_init_params->e_symlink_policy))
+         {
+            continue;
+         }
+         b_is_link = true;
+      }
+
+      if ((DT_REG != uc_type) && (DT_DIR != uc_type))
+      {
+         continue;
+      }
+
+      ui_name_len = pal_strlen (px_dirent->d_name);
+      pc_path = pal_malloc (ui_path_len + ui_name_len + 2, NULL);
+      if (NULL == pc_path)
+      {
+         continue;
+      }
+      (void) snprintf (pc_path, ui_path_len + ui_name_len + 2, "%s/%s",
+         px_dir->pc_path, px_dirent->d_name);
+
+      if (true == walker_does_glob_match (px_walker_ctxt,
+            px_init_params->ppc_exclude_globs,
+            px_init_params->ui_num_exclude_globs, pc_path, px_dirent->d_name))
+      {
+         pal_free (pc_path);
+         pc_path = NULL;
+         continue;
+      }
+
+      if (DT_DIR == uc_type)
+      {
+         i_open_flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+         if (false == b_is_link)
+         {
+            i_open_flags |= O_NOFOLLOW;
+         }
+         i_child_fd = openat (i_dir_fd, px_dirent->d_name, i_open_flags);
+         if ((-1 == i_child_fd) && (EMFILE != errno) && (ENFILE != errno))
+         {
+            walker_skip_dir (px_walker_ctxt, pc_path, errno);
+            pal_free (pc_path);
+            pc_path = NULL;
+            continue;
+         }
+
+         /*
+          * Out of descriptors, the directory is queued by path and opened
+          * again once it is picked up.
+          */
+         (void) walker_push_dir (px_walker_ctxt, px_dir, pc_path, i_child_fd);
+         pc_path = NULL;
+         i_child_fd = -1;
+         continue;
+      }
+
+      if ((px_init_params->ui_num_include_globs > 0) &&
+            (false == walker_does_glob_match (px_walker_ctxt,
+               px_init_params->ppc_include_globs,
+               px_init_params->ui_num_include_globs, pc_path,
+               px_dirent->d_name)))
+      {
+         pal_free (pc_path);
+         pc_path = NULL;
+         continue;
+      }
+
+      px_file = pal_malloc (sizeof(WALKER_FILE_X), NULL);
+      if (NULL == px_file)
+      {
+         pal_free (pc_path);
+         pc_path = NULL;
+         continue;
+      }
+      px_file->px_next = NULL;
+      px_file->pc_path = pc_path;
+      pc_path = NULL;
+
+      if (NULL == x_batch.px_tail)
+      {
+         x_batch.px_head = px_file;
+      }
+      else
+      {
+         x_batch.px_tail->px_next = px_file;
+      }
+      x_batch.px_tail = px_file;
+      x_batch.ui_count++;
+
+      if (x_batch.ui_count >= WALKER_FILE_BATCH_SIZE)
+      {
+         walker_flush_files (px_walker_ctxt, &x_batch);
+      }
+   }
+
+   (void) closedir (p_dir);
+   walker_flush_files (px_walker_ctxt, &x_batch);
+LBL_CLEANUP:
+   walker_free_dir (px_dir);
+   return;
+}
+
+static void *walker_thread (
+   void *p_thread_args)
+{
+   WALKER_CTXT_X *px_walker_ctxt = NULL;
+   WALKER_DIR_X *px_dir = NULL;
+   bool b_walk_complete = false;
+
+   px_walker_ctxt = (WALKER_CTXT_X *) p_thread_args;
+
+   while (1)
+   {
+      (void) pthread_mutex_lock (&(px_walker_ctxt->x_dir_mutex));
+      while ((NULL == px_walker_ctxt->px_dir_stack)
+         && (px_walker_ctxt->ui_pending_dirs > 0)
+         && (false == px_walker_ctxt->b_stop))
+      {
+         (void) pthread_cond_wait (&(px_walker_ctxt->x_dir_cond),
+            &(px_walker_ctxt->x_dir_mutex));
+      }
+
+      if ((NULL == px_walker_ctxt->px_dir_stack)
+         || (true == px_walker_ctxt->b_stop))
+      {
+         (void) pthread_mutex_unlock (&(px_walker_ctxt->x_dir_mutex));
+         break;
+      }
+
+      px_dir = px_walker_ctxt->px_dir_stack;
+      px_walker_ctxt->px_dir_stack = px_dir->px_next;
+      if (-1 != px_dir->i_fd)
+      {
+         px_walker_ctxt->ui_queued_fds--;
+      }
+      (void) pthread_mutex_unlock (&(px_walker_ctxt->x_dir_mutex));
+
+      walker_process_dir (px_walker_ctxt, px_dir);
+      px_dir = NULL;
+
+      (void) pthread_mutex_lock (&(px_walker_ctxt->x_dir_mutex));
+      px_walker_ctxt->ui_pending_dirs--;
+      b_walk_complete = (0 == px_walker_ctxt->ui_pending_dirs);
+      if (true == b_walk_complete)
+      {
+         (void) pthread_cond_broadcast (&(px_walker_ctxt->x_dir_cond));
+      }
+      (void) pthread_mutex_unlock (&(px_walker_ctxt->x_dir_mutex));
+
+      if (true == b_walk_complete)
+      {
+         (void) pthread_mutex_lock (&(px_walker_ctxt->x_file_mutex));
+         px_walker_ctxt->b_walk_complete = true;
+         (void) pthread_cond_broadcast (&(px_walker_ctxt->x_file_cond));
+         (void) pthread_mutex_unlock (&(px_walker_ctxt->x_file_mutex));
+      }
+   }
+
+   return NULL;
+}
+
+static int walker_compare_filenames (
+   const void *p_a,
+   const void *p_b)
+{
+   return strcmp (*(char * const *) p_a, *(char * const *) p_b);
+}
+
+static WALKER_RET_E walker_sort_files (
+   WALKER_CTXT_X *px_walker_ctxt)
+{
+   WALKER_RET_E e_walker_ret = eWALKER_RET_FAILURE;
+   WALKER_FILE_X *px_file = NULL;
+   uint32_t ui_i = 0;
+
+   (void) pthread_mutex_lock (&(px_walker_ctxt->x_file_mutex));
+   while (false == px_walker_ctxt->b_walk_complete)
+   {
+      (void) pthread_cond_wait (&(px_walker_ctxt->x_file_cond),
+         &(px_walker_ctxt->x_file_mutex));
+   }
+   (void) pthread_mutex_unlock (&(px_walker_ctxt->x_file_mutex));
+
+   if (0 == px_walker_ctxt->x_files.ui_count)
+   {
+      e_walker_ret = eWALKER_RET_SUCCESS;
+      goto LBL_CLEANUP;
+   }
+
+   px_walker_ctxt->ppc_sorted_files = pal_malloc (
+      px_walker_ctxt->x_files.ui_count * sizeof(char *), NULL);
+   if (NULL == px_walker_ctxt->ppc_sorted_files)
+   {
+      e_walker_ret = eWALKER_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+
+   while (NULL != px_walker_ctxt->x_files.px_head)
+   {
+      px_file = px_walker_ctxt->x_files.px_head;
+      px_walker_ctxt->x_files.px_head = px_file->px_next;
+      px_walker_ctxt->ppc_sorted_files[ui_i++] = px_file->pc_path;
+      pal_free (px_file);
+   }
+   px_walker_ctxt->x_files.px_tail = NULL;
+   px_walker_ctxt->x_files.ui_count = 0;
+   px_walker_ctxt->ui_num_sorted_files = ui_i;
+
+   qsort (px_walker_ctxt->ppc_sorted_files,
+      px_walker_ctxt->ui_num_sorted_files, sizeof(char *),
+      walker_compare_filenames);
+
+   e_walker_ret = eWALKER_RET_SUCCESS;
+LBL_CLEANUP:
+   return e_walker_ret;
+}
+
+WALKER_RET_E walker_create (
+   WALKER_HDL *phl_walker_hdl,
+   WALKER_INIT_PARAMS_X *px_init_params)
+{
+   WALKER_RET_E e_walker_ret = eWALKER_RET_FAILURE;
+   WALKER_CTXT_X *px_walker_ctxt = NULL;
+   char *pc_root_path = NULL;
+   int i_root_fd = -1;
+   uint32_t ui_i = 0;
+
+   if ((NULL == phl_walker_hdl) || (NULL == px_init_params)
+      || (NULL == px_init_params->pc_root_dir))
+   {
+      e_walker_ret = eWALKER_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   i_root_fd = open (px_init_params->pc_root_dir,
+      O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+   if (-1 == i_root_fd)
+   {
+      e_walker_ret = eWALKER_RET_FAILURE;
+      goto LBL_CLEANUP;
+   }
+
+   px_walker_ctxt = pal_malloc (sizeof(WALKER_CTXT_X), NULL);
+   if (NULL == px_walker_ctxt)
+   {
+      e_walker_ret = eWALKER_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+   (void) pal_memset (px_walker_ctxt, 0x00, sizeof(*px_walker_ctxt));
+   px_walker_ctxt->x_init_params = *px_init_params;
+   px_walker_ctxt->ui_root_len = pal_strlen (px_init_params->pc_root_dir);
+   px_walker_ctxt->ui_max_queued_fds = walker_get_max_queued_fds ();
+
+   if (0 == px_walker_ctxt->x_init_params.ui_num_threads)
+   {
+      px_walker_ctxt->x_init_params.ui_num_threads =
+         WALKER_DEFAULT_NUM_THREADS;
+   }
+   if (px_walker_ctxt->x_init_params.ui_num_threads > WALKER_MAX_NUM_THREADS)
+   {
+      px_walker_ctxt->x_init_params.ui_num_threads = WALKER_MAX_NUM_THREADS;
+   }
+
+   (void) pthread_mutex_init (&(px_walker_ctxt->x_dir_mutex), NULL);
+   (void) pthread_cond_init (&(px_walker_ctxt->x_dir_cond), NULL);
+   (void) pthread_mutex_init (&(px_walker_ctxt->x_file_mutex), NULL);
+   (void) pthread_cond_init (&(px_walker_ctxt->x_file_cond), NULL);
+
+   pc_root_path = pal_malloc (px_walker_ctxt->ui_root_len + 1, NULL);
+   if (NULL == pc_root_path)
+   {
+      e_walker_ret = eWALKER_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+   (void) pal_strncpy (pc_root_path, px_init_params->pc_root_dir,
+      px_walker_ctxt->ui_root_len + 1);
+
+   e_walker_ret = walker_push_dir (px_walker_ctxt, NULL, pc_root_path,
+      i_root_fd);
+   pc_root_path = NULL;
+   i_root_fd = -1;
+   if (eWALKER_RET_SUCCESS != e_walker_ret)
+   {
+      goto LBL_CLEANUP;
+   }
+
+   px_walker_ctxt->px_threads = pal_malloc (
+      px_walker_ctxt->x_init_params.ui_num_threads * sizeof(pthread_t), NULL);
+   if (NULL == px_walker_ctxt->px_threads)
+   {
+      e_walker_ret = eWALKER_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+
+   for (ui_i = 0; ui_i < px_walker_ctxt->x_init_params.ui_num_threads; ui_i++)
+   {
+      if (0 != pthread_create (&(px_walker_ctxt->px_threads[ui_i]), NULL,
+            walker_thread, px_walker_ctxt))
+      {
+         break;
+      }
+      px_walker_ctxt->ui_num_threads++;
+   }
+
+   if (0 == px_walker_ctxt->ui_num_threads)
+   {
+      e_walker_ret = eWALKER_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+
+   *phl_walker_hdl = px_walker_ctxt;
+   px_walker_ctxt = NULL;
+   e_walker_ret = eWALKER_RET_SUCCESS;
+LBL_CLEANUP:
+   if (-1 != i_root_fd)
+   {
+      (void) close (i_root_fd);
+   }
+   if (NULL != px_walker_ctxt)
+   {
+      (void) walker_delete (px_walker_ctxt);
+   }
+   return e_walker_ret;
+}
+
+WALKER_RET_E walker_get_next_file (
+   WALKER_HDL hl_walker_hdl,
+   char **ppc_filename)
+{
+   WALKER_RET_E e_walker_ret = eWALKER_RET_FAILURE;
+   WALKER_CTXT_X *px_walker_ctxt = NULL;
+   WALKER_FILE_X *px_file = NULL;
+
+   if ((NULL == hl_walker_hdl) || (NULL == ppc_filename))
+   {
+      e_walker_ret = eWALKER_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   px_walker_ctxt = (WALKER_CTXT_X *) hl_walker_hdl;
+
+   if (true == px_walker_ctxt->x_init_params.b_sort_files)
+   {
+      if (NULL == px_walker_ctxt->ppc_sorted_files)
+      {
+         e_walker_ret = walker_sort_files (px_walker_ctxt);
+         if (eWALKER_RET_SUCCESS != e_walker_ret)
+         {
+            goto LBL_CLEANUP;
+         }
+      }
+
+      if (px_walker_ctxt->ui_next_sorted_file >=
+            px_walker_ctxt->ui_num_sorted_files)
+      {
+         e_walker_ret = eWALKER_RET_WALK_COMPLETE;
+      }
+      else
+      {
+         *ppc_filename = px_walker_ctxt->ppc_sorted_files[
+            px_walker_ctxt->ui_next_sorted_file];
+         px_walker_ctxt->ppc_sorted_files[
+            px_walker_ctxt->ui_next_sorted_file] = NULL;
+         px_walker_ctxt->ui_next_sorted_file++;
+         e_walker_ret = eWALKER_RET_SUCCESS;
+      }
+      goto LBL_CLEANUP;
+   }
+
+   (void) pthread_mutex_lock (&(px_walker_ctxt->x_file_mutex));
+   while ((NULL == px_walker_ctxt->x_files.px_head)
+      && (false == px_walker_ctxt->b_walk_complete))
+   {
+      (void) pthread_cond_wait (&(px_walker_ctxt->x_file_cond),
+         &(px_walker_ctxt->x_file_mutex));
+   }
+
+   px_file = px_walker_ctxt->x_files.px_head;
+   if (NULL != px_file)
+   {
+      px_walker_ctxt->x_files.px_head = px_file->px_next;
+      if (NULL == px_walker_ctxt->x_files.px_head)
+      {
+         px_walker_ctxt->x_files.px_tail = NULL;
+      }
+      px_walker_ctxt->x_files.ui_count--;
+   }
+   (void) pthread_mutex_unlock (&(px_walker_ctxt->x_file_mutex));
+
+   if (NULL == px_file)
+   {
+      e_walker_ret = eWALKER_RET_WALK_COMPLETE;
+   }
+   else
+   {
+      *ppc_filename = px_file->pc_path;
+      pal_free (px_file);
+      e_walker_ret = eWALKER_RET_SUCCESS;
+   }
+LBL_CLEANUP:
+   return e_walker_ret;
+}
+
+WALKER_RET_E walker_get_stats (
+   WALKER_HDL hl_walker_hdl,
+   WALKER_STATS_X *px_stats)
+{
+   WALKER_RET_E e_walker_ret = eWALKER_RET_FAILURE;
+   WALKER_CTXT_X *px_walker_ctxt = NULL;
+
+   if ((NULL == hl_walker_hdl) || (NULL == px_stats))
+   {
+      e_walker_ret = eWALKER_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   px_walker_ctxt = (WALKER_CTXT_X *) hl_walker_hdl;
+
+   (void) pthread_mutex_lock (&(px_walker_ctxt->x_dir_mutex));
+   px_stats->ui_num_skipped_dirs = px_walker_ctxt->ui_num_skipped_dirs;
+   (void) pthread_mutex_unlock (&(px_walker_ctxt->x_dir_mutex));
+   e_walker_ret = eWALKER_RET_SUCCESS;
+LBL_CLEANUP:
+   return e_walker_ret;
+}
+
+WALKER_RET_E walker_delete (
+   WALKER_HDL hl_walker_hdl)
+{
+   WALKER_RET_E e_walker_ret = eWALKER_RET_FAILURE;
+   WALKER_CTXT_X *px_walker_ctxt = NULL;
+   WALKER_DIR_X *px_dir = NULL;
+   WALKER_FILE_X *px_file = NULL;
+   uint32_t ui_i = 0;
+
+   if (NULL == hl_walker_hdl)
+   {
+      e_walker_ret = eWALKER_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   px_walker_ctxt = (WALKER_CTXT_X *) hl_walker_hdl;
+
+   (void) pthread_mutex_lock (&(px_walker_ctxt->x_dir_mutex));
+   px_walker_ctxt->b_stop = true;
+   (void) pthread_cond_broadcast (&(px_walker_ctxt->x_dir_cond));
+   (void) pthread_mutex_unlock (&(px_walker_ctxt->x_dir_mutex));
+
+   for (ui_i = 0; ui_i < px_walker_ctxt->ui_num_threads; ui_i++)
+   {
+      (void) pthread_join (px_walker_ctxt->px_threads[ui_i], NULL);
+   }
+
+   while (NULL != px_walker_ctxt->px_dir_stack)
+   {
+      px_dir = px_walker_ctxt->px_dir_stack;
+      px_walker_ctxt->px_dir_stack = px_dir->px_next;
+      walker_free_dir (px_dir);
+   }
+
+   while (NULL != px_walker_ctxt->x_files.px_head)
+   {
+      px_file = px_walker_ctxt->x_files.px_head;
+      px_walker_ctxt->x_files.px_head = px_file->px_next;
+      pal_free (px_file->pc_path);
+      pal_free (px_file);
+   }
+
+   if (NULL != px_walker_ctxt->ppc_sorted_files)
+   {
+      for (ui_i = px_walker_ctxt->ui_next_sorted_file;
+            ui_i < px_walker_ctxt->ui_num_sorted_files; ui_i++)
+      {
+         pal_free (px_walker_ctxt->ppc_sorted_files[ui_i]);
+      }
+      pal_free (px_walker_ctxt->ppc_sorted_files);
+   }
+
+   if (NULL != px_walker_ctxt->px_threads)
+   {
+      pal_free (px_walker_ctxt->px_threads);
+   }
+
+   (void) pthread_cond_destroy (&(px_walker_ctxt->x_file_cond));
+   (void) pthread_mutex_destroy (&(px_walker_ctxt->x_file_mutex));
+   (void) pthread_cond_destroy (&(px_walker_ctxt->x_dir_cond));
+   (void) pthread_mutex_destroy (&(px_walker_ctxt->x_dir_mutex));
+
+   pal_free (px_walker_ctxt);
+   e_walker_ret = eWALKER_RET_SUCCESS;
+LBL_CLEANUP:
+   return e_walker_ret;
+}
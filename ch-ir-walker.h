@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * Copyright (c) 2026, agent <agent@local>
+ *
+ * \file   ch-ir-walker.h
+ *
+ * \author agent
+ *
+ * \date   Oct 18, 2026
+ *
+ * \brief  Parallel directory tree walker. A pool of threads traverses the
+ *         tree rooted at a given directory and queues up the regular files
+ *         it discovers. The files can be consumed using
+ *         walker_get_next_file while the traversal is still in progress.
+ *
+ ******************************************************************************/
+
+#ifndef __CH_IR_WALKER_H__
+#define __CH_IR_WALKER_H__
+
+#include <ch-pal/exp_pal.h>
+
+/********************************** MACROS ************************************/
+#define WALKER_DEFAULT_NUM_THREADS     (4)
+#define WALKER_MAX_NUM_THREADS         (64)
+
+/******************************** ENUMERATIONS ********************************/
+typedef enum _WALKER_RET_E
+{
+   eWALKER_RET_SUCCESS = 0,
+
+   eWALKER_RET_FAILURE,
+
+   eWALKER_RET_INVALID_ARGS,
+
+   eWALKER_RET_RESOURCE_FAILURE,
+
+   /*
+    * Returned by walker_get_next_file once the traversal is complete and all
+    * the discovered files have been handed out.
+    */
+   eWALKER_RET_WALK_COMPLETE
+} WALKER_RET_E;
+
+typedef enum _WALKER_SYMLINK_POLICY_E
+{
+   /*
+    * Symbolic links are ignored. This is the default.
+    */
+   eWALKER_SYMLINK_POLICY_SKIP = 0,
+
+   /*
+    * Symbolic links to regular files are followed, links to directories are
+    * ignored.
+    */
+   eWALKER_SYMLINK_POLICY_FOLLOW_FILES,
+
+   /*
+    * All symbolic links are followed. Directory loops are detected and
+    * skipped.
+    */
+   eWALKER_SYMLINK_POLICY_FOLLOW_ALL
+} WALKER_SYMLINK_POLICY_E;
+
+/*********************** CLASS/STRUCTURE/UNION DATA TYPES *********************/
+typedef struct _WALKER_CTXT_X *WALKER_HDL;
+
+typedef struct _WALKER_INIT_PARAMS_X
+{
+   /*
+    * Root of the tree to walk. The discovered file names are of the form
+    * "<pc_root_dir>/<relative path>".
+    */
+   char *pc_root_dir;
+
+   /*
+    * Number of traversal threads. 0 selects WALKER_DEFAULT_NUM_THREADS.
+    */
+   uint32_t ui_num_threads;
+
+   /*
+    * fnmatch(3) patterns. A pattern containing a '/' is matched against the
+    * path relative to pc_root_dir, otherwise against the entry name. If
+    * include patterns are given, only files matching at least one of them
+    * are returned. Files and directories matching an exclude pattern are
+    * skipped. The arrays must stay valid until walker_delete.
+    */
+   char **ppc_include_globs;
+
+   uint32_t ui_num_include_globs;
+
+   char **ppc_exclude_globs;
+
+   uint32_t ui_num_exclude_globs;
+
+   WALKER_SYMLINK_POLICY_E e_symlink_policy;
+
+   /*
+    * If true, walker_get_next_file blocks until the traversal is complete and
+    * then returns the files in strcmp order. Otherwise files are returned in
+    * the order they are discovered.
+    */
+   bool b_sort_files;
+} WALKER_INIT_PARAMS_X;
+
+typedef struct _WALKER_STATS_X
+{
+   /*
+    * Directories which could not be opened or read. Each one is also
+    * reported on stderr.
+    */
+   uint32_t ui_num_skipped_dirs;
+} WALKER_STATS_X;
+
+/***************************** FUNCTION PROTOTYPES ****************************/
+WALKER_RET_E walker_create (
+   WALKER_HDL *phl_walker_hdl,
+   WALKER_INIT_PARAMS_X *px_init_params);
+
+/*
+ * Blocks until a file is available. On success *ppc_filename is owned by the
+ * caller and must be released using pal_free.
+ */
+WALKER_RET_E walker_get_next_file (
+   WALKER_HDL hl_walker_hdl,
+   char **ppc_filename);
+
+/*
+ * The statistics are final once walker_get_next_file has returned
+ * eWALKER_RET_WALK_COMPLETE.
+ */
+WALKER_RET_E walker_get_stats (
+   WALKER_HDL hl_walker_hdl,
+   WALKER_STATS_X *px_stats);
+
+WALKER_RET_E walker_delete (
+   WALKER_HDL hl_walker_hdl);
+
+#endif /* __CH_IR_WALKER_H__ */
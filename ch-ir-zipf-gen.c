@@ -0,0 +1,245 @@
+/*******************************************************************************
+ * Copyright (c) 2026, agent <agent@local>
+ *
+ * \file   ch-ir-zipf-gen.c
+ *
+ * \author agent
+ *
+ * \date   Oct 18, 2026
+ *
+ * \brief  Generates a corpus of text files whose words follow a Zipfian
+ *         distribution, for benchmarking the tokenizer. The output only
+ *         depends on the arguments, so runs on different machines tokenize
+ *         the same input.
+ *
+ *         The word of rank r is r written in base 26 with the letters 'a' to
+ *         'z', so that, as in natural language, the most frequent words are
+ *         the shortest.
+ *
+ *         Usage:
+ *         ./ch-ir-zipf-gen <Output Directory> [<Files> [<Words Per File>
+ *            [<Vocabulary Size> [<Exponent> [<Seed>]]]]]
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#define ZIPF_DEFAULT_NUM_FILES         (400)
+#define ZIPF_DEFAULT_WORDS_PER_FILE    (7500)
+#define ZIPF_DEFAULT_VOCABULARY_SIZE   (10000)
+#define ZIPF_DEFAULT_EXPONENT          (1.0)
+#define ZIPF_DEFAULT_SEED              (1)
+#define ZIPF_WORDS_PER_LINE            (12)
+#define ZIPF_MAX_WORD_LEN              (16)
+
+static uint64_t gui64_rand_state = ZIPF_DEFAULT_SEED;
+
+static uint64_t zipf_rand (
+   void);
+
+static uint32_t zipf_sample (
+   double *pd_cdf,
+   uint32_t ui_vocabulary_size);
+
+static void zipf_make_word (
+   uint32_t ui_rank,
+   char *pc_word);
+
+/*
+ * xorshift64*, chosen over rand() so that the corpus is the same with every C
+ * library.
+ */
+static uint64_t zipf_rand (
+   void)
+{
+   gui64_rand_state ^= gui64_rand_state >> 12;
+   gui64_rand_state ^= gui64_rand_state << 25;
+   gui64_rand_state ^= gui64_rand_state >> 27;
+   return gui64_rand_state * 2685821657736338717ULL;
+}
+
+/*
+ * Returns a rank in [0, ui_vocabulary_size) by binary search of the
+ * cumulative distribution.
+ */
+static uint32_t zipf_sample (
+   double *pd_cdf,
+   uint32_t ui_vocabulary_size)
+{
+   double d_u = 0.0;
+   uint32_t ui_low = 0;
+   uint32_t ui_high = ui_vocabulary_size - 1;
+   uint32_t ui_mid = 0;
+
+   d_u = (double) (zipf_rand () >> 11) / (double) (1ULL << 53);
+
+   while (ui_low < ui_high)
+   {
+      ui_mid = ui_low + ((ui_high - ui_low) / 2);
+      if (pd_cdf[ui_mid] < d_u)
+      {
+         ui_low = ui_mid + 1;
+      }
+      else
+      {
+         ui_high = ui_mid;
+      }
+   }
+   return ui_low;
+}
+
+static void zipf_make_word (
+   uint32_t ui_rank,
+   char *pc_word)
+{
+   char ca_reversed[ZIPF_MAX_WORD_LEN] = {0};
+   uint32_t ui_len = 0;
+   uint32_t ui_i = 0;
+
+   do
+   {
+      ca_reversed[ui_len++] = 'a' + (ui_rank % 26);
+      ui_rank /= 26;
+   } while (ui_rank > 0);
+
+   for (ui_i = 0; ui_i < ui_len; ui_i++)
+   {
+      pc_word[ui_i] = ca_reversed[ui_len - 1 - ui_i];
+   }
+   pc_word[ui_len] = '\0';
+}
+
+int main (
+   int i_argc,
+   char **ppc_argv)
+{
+   int i_ret_val = -1;
+   char *pc_out_dir = NULL;
+   uint32_t ui_num_files = ZIPF_DEFAULT_NUM_FILES;
+   uint32_t ui_words_per_file = ZIPF_DEFAULT_WORDS_PER_FILE;
+   uint32_t ui_vocabulary_size = ZIPF_DEFAULT_VOCABULARY_SIZE;
+   double d_exponent = ZIPF_DEFAULT_EXPONENT;
+   double *pd_cdf = NULL;
+   double d_sum = 0.0;
+   char ca_word[ZIPF_MAX_WORD_LEN] = {0};
+   char *pc_path = NULL;
+   size_t x_path_size = 0;
+   FILE *p_file = NULL;
+   uint32_t ui_file = 0;
+   uint32_t ui_word = 0;
+   uint32_t ui_i = 0;
+
+   if ((i_argc < 2) || (i_argc > 7))
+   {
+      printf ("\n Usage:"
+         "\n \t%s <Output Directory> [<Files (Default: %d)> "
+         "[<Words Per File (Default: %d)> [<Vocabulary Size (Default: %d)> "
+         "[<Exponent (Default: %.1lf)> [<Seed (Default: %d)>]]]]]\n",
+         ppc_argv[0], ZIPF_DEFAULT_NUM_FILES, ZIPF_DEFAULT_WORDS_PER_FILE,
+         ZIPF_DEFAULT_VOCABULARY_SIZE, ZIPF_DEFAULT_EXPONENT,
+         ZIPF_DEFAULT_SEED);
+      goto LBL_CLEANUP;
+   }
+
+   pc_out_dir = ppc_argv[1];
+   if (i_argc > 2)
+   {
+      ui_num_files = (uint32_t) strtoul (ppc_argv[2], NULL, 10);
+   }
+   if (i_argc > 3)
+   {
+      ui_words_per_file = (uint32_t) strtoul (ppc_argv[3], NULL, 10);
+   }
+   if (i_argc > 4)
+   {
+      ui_vocabulary_size = (uint32_t) strtoul (ppc_argv[4], NULL, 10);
+   }
+   if (i_argc > 5)
+   {
+      d_exponent = strtod (ppc_argv[5], NULL);
+   }
+   if (i_argc > 6)
+   {
+      gui64_rand_state = strtoull (ppc_argv[6], NULL, 10);
+   }
+   if ((0 == ui_vocabulary_size) || (0 == gui64_rand_state))
+   {
+      printf ("The vocabulary size and the seed must not be 0\n");
+      goto LBL_CLEANUP;
+   }
+
+   if ((0 != mkdir (pc_out_dir, 0755)) && (EEXIST != errno))
+   {
+      printf ("mkdir failed for \"%s\": %s\n", pc_out_dir, strerror (errno));
+      goto LBL_CLEANUP;
+   }
+
+   pd_cdf = malloc (ui_vocabulary_size * sizeof(double));
+   x_path_size = strlen (pc_out_dir) + 32;
+   pc_path = malloc (x_path_size);
+   if ((NULL == pd_cdf) || (NULL == pc_path))
+   {
+      goto LBL_CLEANUP;
+   }
+
+   for (ui_i = 0; ui_i < ui_vocabulary_size; ui_i++)
+   {
+      d_sum += 1.0 / pow ((double) (ui_i + 1), d_exponent);
+      pd_cdf[ui_i] = d_sum;
+   }
+   for (ui_i = 0; ui_i < ui_vocabulary_size; ui_i++)
+   {
+      pd_cdf[ui_i] /= d_sum;
+   }
+
+   for (ui_file = 0; ui_file < ui_num_files; ui_file++)
+   {
+      (void) snprintf (pc_path, x_path_size, "%s/d%05u", pc_out_dir, ui_file);
+      p_file = fopen (pc_path, "w");
+      if (NULL == p_file)
+      {
+         printf ("fopen failed for \"%s\": %s\n", pc_path, strerror (errno));
+         goto LBL_CLEANUP;
+      }
+
+      for (ui_word = 0; ui_word < ui_words_per_file; ui_word++)
+      {
+         zipf_make_word (zipf_sample (pd_cdf, ui_vocabulary_size), ca_word);
+         (void) fputs (ca_word, p_file);
+         (void) fputc (((ui_word + 1) % ZIPF_WORDS_PER_LINE) ? ' ' : '\n',
+            p_file);
+      }
+      (void) fputc ('\n', p_file);
+
+      if (0 != fclose (p_file))
+      {
+         p_file = NULL;
+         printf ("fclose failed for \"%s\": %s\n", pc_path, strerror (errno));
+         goto LBL_CLEANUP;
+      }
+      p_file = NULL;
+   }
+
+   i_ret_val = 0;
+LBL_CLEANUP:
+   if (NULL != p_file)
+   {
+      (void) fclose (p_file);
+   }
+   if (NULL != pc_path)
+   {
+      free (pc_path);
+   }
+   if (NULL != pd_cdf)
+   {
+      free (pd_cdf);
+   }
+   return i_ret_val;
+}
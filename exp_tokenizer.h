@@ -0,0 +1,159 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Sandeep Prakash <sxp121331@utdallas.edu>
+ *
+ * \file   exp_tokenizer.h
+ *
+ * \author sandeepprakash
+ *
+ * \date   Feb 11, 2014
+ *
+ * \brief  Exported interface of the tokenizer library. A tokenizer context
+ *         splits the text fed to it into tokens and counts the occurances of
+ *         each token. Contexts are independent of each other; a context must
+ *         not be used by more than one thread at a time.
+ *
+ *         Usage:
+ *            tokenizer_create
+ *            tokenizer_feed ... tokenizer_feed, tokenizer_finish  (per input)
+ *            tokenizer_for_each_token / tokenizer_get_stats
+ *            tokenizer_delete
+ *
+ ******************************************************************************/
+
+#ifndef __EXP_TOKENIZER_H__
+#define __EXP_TOKENIZER_H__
+
+#include <ch-pal/exp_pal.h>
+
+/********************************** MACROS ************************************/
+#define TOKENIZER_DEFAULT_HM_TABLE_SIZE      (1000)
+#define TOKENIZER_DEFAULT_HOT_CACHE_SIZE     (1024)
+#define TOKENIZER_MAX_HOT_CACHE_SIZE         (65536)
+
+/******************************** ENUMERATIONS ********************************/
+typedef enum _TOKENIZER_RET_E
+{
+   eTOKENIZER_RET_SUCCESS = 0,
+
+   eTOKENIZER_RET_FAILURE,
+
+   eTOKENIZER_RET_INVALID_ARGS,
+
+   eTOKENIZER_RET_RESOURCE_FAILURE
+} TOKENIZER_RET_E;
+
+/*********************** CLASS/STRUCTURE/UNION DATA TYPES *********************/
+typedef struct _TOKENIZER_CTXT_X *TOKENIZER_HDL;
+
+/*
+ * Called for every token as it is found. pc_token points into the buffer
+ * passed to tokenizer_feed, or for a token split across two buffers into a
+ * buffer internal to the context. It is neither NUL terminated nor case
+ * folded and is only valid for the duration of the call.
+ */
+typedef void (*pfn_tokenizer_token_cbk) (
+   const char *pc_token,
+   uint32_t ui_token_len,
+   void *p_app_data);
+
+/*
+ * Called by tokenizer_for_each_token. pc_token is lower case and NUL
+ * terminated, and is only valid for the duration of the call. Returning
+ * anything other than eTOKENIZER_RET_SUCCESS stops the iteration.
+ */
+typedef TOKENIZER_RET_E (*pfn_tokenizer_for_each_cbk) (
+   const char *pc_token,
+   uint32_t ui_token_len,
+   uint64_t ui64_count,
+   void *p_app_data);
+
+typedef struct _TOKENIZER_INIT_PARAMS_X
+{
+   /*
+    * Table size of the token hashmap. 0 selects
+    * TOKENIZER_DEFAULT_HM_TABLE_SIZE.
+    */
+   uint32_t ui_hm_table_size;
+
+   /*
+    * Number of entries in the hot token cache, a power of 2 not larger than
+    * TOKENIZER_MAX_HOT_CACHE_SIZE. 0 disables the cache.
+    */
+   uint32_t ui_hot_cache_size;
+
+   /*
+    * If true the tokens are only handed to fn_token_cbk and are not counted.
+    */
+   bool b_no_count;
+
+   /*
+    * Optional.
+    */
+   pfn_tokenizer_token_cbk fn_token_cbk;
+
+   void *p_app_data;
+} TOKENIZER_INIT_PARAMS_X;
+
+/*
+ * The counts of tokens are 64 bit; a long run can see more than 2^32 of them.
+ */
+typedef struct _TOKENIZER_STATS_X
+{
+   uint64_t ui64_num_tokens;
+
+   uint32_t ui_num_unique_tokens;
+
+   uint64_t ui64_hot_cache_hits;
+
+   uint64_t ui64_hot_cache_lookups;
+} TOKENIZER_STATS_X;
+
+/***************************** FUNCTION PROTOTYPES ****************************/
+TOKENIZER_RET_E tokenizer_create (
+   TOKENIZER_HDL *phl_tokenizer_hdl,
+   TOKENIZER_INIT_PARAMS_X *px_init_params);
+
+/*
+ * Tokenizes the next ui_buf_len bytes of the input. The input may be split
+ * at any byte; a token spanning two buffers is completed by the next call.
+ * A NUL byte ends the line it is on; the rest of that line is skipped.
+ */
+TOKENIZER_RET_E tokenizer_feed (
+   TOKENIZER_HDL hl_tokenizer_hdl,
+   const char *pc_buf,
+   uint32_t ui_buf_len);
+
+/*
+ * Marks the end of the current input, e.g. a document, and completes any
+ * token in progress. The context can be fed a new input afterwards.
+ */
+TOKENIZER_RET_E tokenizer_finish (
+   TOKENIZER_HDL hl_tokenizer_hdl);
+
+/*
+ * Iterates over the counted tokens in no particular order. Can be called at
+ * any time; a token in progress is not seen until its input is finished.
+ */
+TOKENIZER_RET_E tokenizer_for_each_token (
+   TOKENIZER_HDL hl_tokenizer_hdl,
+   pfn_tokenizer_for_each_cbk fn_for_each_cbk,
+   void *p_app_data);
+
+/*
+ * Adds ui64_count occurances of a lower case token, for example one saved by
+ * an earlier run.
+ */
+TOKENIZER_RET_E tokenizer_add_token (
+   TOKENIZER_HDL hl_tokenizer_hdl,
+   const char *pc_token,
+   uint32_t ui_token_len,
+   uint64_t ui64_count);
+
+TOKENIZER_RET_E tokenizer_get_stats (
+   TOKENIZER_HDL hl_tokenizer_hdl,
+   TOKENIZER_STATS_X *px_stats);
+
+TOKENIZER_RET_E tokenizer_delete (
+   TOKENIZER_HDL hl_tokenizer_hdl);
+
+#endif /* __EXP_TOKENIZER_H__ */
@@ -0,0 +1,1086 @@
+/*******************************************************************************
+ * Copyright (c) 2014, Sandeep Prakash <sxp121331@utdallas.edu>
+ *
+ * \file   tokenizer.c
+ *
+ * \author sandeepprakash
+ *
+ * \date   Feb 11, 2014
+ *
+ * \brief  Tokenizer library.
+ *
+ * The scanner works directly on the buffers handed to tokenizer_feed. A token
+ * is tracked as an offset and a length into the buffer and is handed out as
+ * such, so nothing is copied or cleared per token. Only a token which is cut
+ * by the end of a buffer is carried over into pc_carry until the next call
+ * completes it.
+ *
+ * Rules, applied per line:
+ *    - ',', '!', ' ', '(', ')' and '/' end a token. So do '.' and the end of
+ *      the line.
+ *    - A '.' between digits is kept, e.g. "10.901". This also holds after a
+ *      '<' or '>': the '.' is kept and the digits after it are ignored, e.g.
+ *      "12<x.5" gives "12.".
+ *    - A token enclosed in single quotes is stripped of them, except when it
+ *      is ended by a '.'.
+ *    - Everything after a '<' or '>' up to the end of the line is ignored.
+ *    - A NUL byte ends the line; the rest of it up to the '\n' is skipped.
+ *
+ * Tokens are counted case insensitively in a hashmap, with a small direct
+ * mapped cache of short tokens in front of it.
+ *
+ ******************************************************************************/
+
+#include <ctype.h>
+#include <string.h>
+#include <ch-pal/exp_pal.h>
+#include <ch-utils/exp_hashmap.h>
+#include "exp_tokenizer.h"
+
+#define HOT_CACHE_MAX_TOKEN_LEN        (8)
+#define TOKENIZER_MIN_BUF_SIZE         (256)
+
+#define TOKENIZER_IS_DIGIT(c)          (((c) >= '0') && ((c) <= '9'))
+
+typedef struct _TOKEN_STATS_X
+{
+   char *pc_token;
+
+   uint32_t ui_token_len;
+
+   uint64_t ui64_num_occurances;
+} TOKEN_STATS_X;
+
+/*
+ * Entry in the hot token cache. Tokens of up to HOT_CACHE_MAX_TOKEN_LEN bytes
+ * are packed, zero padded, into ui64_key and counted in ui_count. The count is
+ * added to the hashmap when the entry is evicted or the cache is flushed, and
+ * before it would wrap.
+ * us_score goes up on a hit and down on a miss; the entry is only replaced
+ * once it drops to 0 so that rare tokens do not push out the hot ones.
+ */
+typedef struct _HOT_CACHE_ENTRY_X
+{
+   uint64_t ui64_key;
+
+   uint16_t us_token_len;
+
+   uint16_t us_score;
+
+   uint32_t ui_count;
+} HOT_CACHE_ENTRY_X;
+
+typedef struct _TOKENIZER_CTXT_X
+{
+   TOKENIZER_INIT_PARAMS_X x_init_params;
+
+   HM_HDL hl_token_hm;
+
+   /*
+    * Direct mapped cache in front of hl_token_hm. Natural language is
+    * Zipfian; a handful of short tokens ("the", "of", "and", ...) make up a
+    * large fraction of all the tokens and are counted here without hashing
+    * and comparing the full string in the hashmap.
+    */
+   HOT_CACHE_ENTRY_X *px_hot_cache;
+
+   uint32_t ui_hot_cache_size;
+
+   uint32_t ui_hot_cache_mask;
+
+   TOKENIZER_STATS_X x_stats;
+
+   /*
+    * Scanner state carried from one tokenizer_feed to the next.
+    */
+   bool b_ignore;
+
+   /*
+    * A NUL was seen; everything up to the next '\n' is skipped.
+    */
+   bool b_skip_line;
+
+   /*
+    * All the characters of the token in progress after the first one are
+    * digits.
+    */
+   bool b_numeric;
+
+   /*
+    * The last buffer ended with a '.' following a numeric token. Whether the
+    * '.' is part of the token depends on the next character.
+    */
+   bool b_pending_dot;
+
+   char *pc_carry;
+
+   uint32_t ui_carry_len;
+
+   uint32_t ui_carry_size;
+
+   /*
+    * Lower case, NUL terminated copy of the token being looked up in the
+    * hashmap.
+    */
+   char *pc_key;
+
+   uint32_t ui_key_size;
+} TOKENIZER_CTXT_X;
+
+typedef struct _TOKENIZER_FOR_EACH_CTXT_X
+{
+   pfn_tokenizer_for_each_cbk fn_for_each_cbk;
+
+   void *p_app_data;
+
+   TOKENIZER_RET_E e_cbk_ret;
+} TOKENIZER_FOR_EACH_CTXT_X;
+
+static bool tokenizer_grow_buf (
+   char **ppc_buf,
+   uint32_t *pui_buf_size,
+   uint32_t ui_min_size,
+   uint32_t ui_used);
+
+static char *tokenizer_make_key (
+   TOKENIZER_CTXT_X *px_tok_ctxt,
+   const char *pc_token,
+   uint32_t ui_token_len);
+
+static TOKENIZER_RET_E update_token_stats (
+   TOKENIZER_CTXT_X *px_tok_ctxt,
+   const char *pc_key,
+   uint32_t ui_key_len,
+   uint64_t ui64_count);
+
+static TOKENIZER_RET_E hot_cache_write_back (
+   TOKENIZER_CTXT_X *px_tok_ctxt,
+   HOT_CACHE_ENTRY_X *px_entry);
+
+static TOKENIZER_RET_E hot_cache_evict (
+   TOKENIZER_CTXT_X *px_tok_ctxt,
+   HOT_CACHE_ENTRY_X *px_entry);
+
+static TOKENIZER_RET_E hot_cache_flush (
+   TOKENIZER_CTXT_X *px_tok_ctxt);
+
+static TOKENIZER_RET_E count_token (
+   TOKENIZER_CTXT_X *px_tok_ctxt,
+   const char *pc_token,
+   uint32_t ui_token_len);
+
+static TOKENIZER_RET_E emit_token (
+   TOKENIZER_CTXT_X *px_tok_ctxt,
+   const char *pc_buf,
+   uint32_t ui_token_start,
+   uint32_t ui_token_len,
+   bool b_strip_quotes);
+
+static TOKENIZER_RET_E carry_token (
+   TOKENIZER_CTXT_X *px_tok_ctxt,
+   const char *pc_buf,
+   uint32_t ui_token_start,
+   uint32_t ui_token_len,
+   bool b_add_dot);
+
+static TOKENIZER_RET_E scan_buffer (
+   TOKENIZER_CTXT_X *px_tok_ctxt,
+   const char *pc_buf,
+   uint32_t ui_buf_len);
+
+static HM_RET_E fn_hm_for_each_cbk (
+   HM_NODE_DATA_X *px_curr_node_data,
+   void *p_app_data);
+
+static HM_RET_E fn_hm_delete_cbk (
+   HM_NODE_DATA_X *px_curr_node_data,
+   void *p_app_data);
+
+/*
+ * Grows *ppc_buf to hold at least ui_min_size bytes, keeping the first
+ * ui_used bytes.
+ */
+static bool tokenizer_grow_buf (
+   char **ppc_buf,
+   uint32_t *pui_buf_size,
+   uint32_t ui_min_size,
+   uint32_t ui_used)
+{
+   bool b_grown = false;
+   char *pc_buf = NULL;
+   uint32_t ui_buf_size = 0;
+
+   if (ui_min_size <= *pui_buf_size)
+   {
+      b_grown = true;
+      goto LBL_CLEANUP;
+   }
+
+   ui_buf_size = (0 == *pui_buf_size) ? TOKENIZER_MIN_BUF_SIZE : *pui_buf_size;
+   while (ui_buf_size < ui_min_size)
+   {
+      ui_buf_size *= 2;
+   }
+
+   pc_buf = pal_malloc (ui_buf_size, NULL);
+   if (NULL == pc_buf)
+   {
+      goto LBL_CLEANUP;
+   }
+   if (NULL != *ppc_buf)
+   {
+      (void) pal_memmove (pc_buf, *ppc_buf, ui_used);
+      pal_free (*ppc_buf);
+   }
+   *ppc_buf = pc_buf;
+   *pui_buf_size = ui_buf_size;
+   b_grown = true;
+LBL_CLEANUP:
+   return b_grown;
+}
+
+static char *tokenizer_make_key (
+   TOKENIZER_CTXT_X *px_tok_ctxt,
+   const char *pc_token,
+   uint32_t ui_token_len)
+{
+   char *pc_key = NULL;
+   uint32_t ui_i = 0;
+
+   if (false == tokenizer_grow_buf (&(px_tok_ctxt->pc_key),
+         &(px_tok_ctxt->ui_key_size), ui_token_len + 1, 0))
+   {
+      goto LBL_CLEANUP;
+   }
+
+   pc_key = px_tok_ctxt->pc_key;
+   for (ui_i = 0; ui_i < ui_token_len; ui_i++)
+   {
+      pc_key[ui_i] = (char) tolower ((unsigned char) pc_token[ui_i]);
+   }
+   pc_key[ui_token_len] = '\0';
+LBL_CLEANUP:
+   return pc_key;
+}
+
+static TOKENIZER_RET_E update_token_stats (
+   TOKENIZER_CTXT_X *px_tok_ctxt,
+   const char *pc_key,
+   uint32_t ui_key_len,
+   uint64_t ui64_count)
+{
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_FAILURE;
+   HM_RET_E e_hm_ret = eHM_RET_FAILURE;
+   HM_NODE_DATA_X x_node_data = { eHM_KEY_TYPE_INVALID };
+   TOKEN_STATS_X *px_token_stats = NULL;
+
+   (void) pal_memset (&x_node_data, 0x00, sizeof(x_node_data));
+   x_node_data.e_hm_key_type = eHM_KEY_TYPE_STRING;
+   x_node_data.u_hm_key.puc_str_key = (uint8_t *) pc_key;
+   e_hm_ret = hm_search_node (px_tok_ctxt->hl_token_hm, &x_node_data);
+   if (eHM_RET_HM_NODE_FOUND == e_hm_ret)
+   {
+      px_token_stats = (TOKEN_STATS_X *) x_node_data.p_data;
+      px_token_stats->ui64_num_occurances += ui64_count;
+      e_tok_ret = eTOKENIZER_RET_SUCCESS;
+      goto LBL_CLEANUP;
+   }
+
+   px_token_stats = pal_malloc (sizeof(TOKEN_STATS_X), NULL);
+   if (NULL == px_token_stats)
+   {
+      e_tok_ret = eTOKENIZER_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+   px_token_stats->pc_token = pal_malloc (ui_key_len + 1, NULL);
+   if (NULL == px_token_stats->pc_token)
+   {
+      pal_free (px_token_stats);
+      e_tok_ret = eTOKENIZER_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+   (void) pal_memmove (px_token_stats->pc_token, pc_key, ui_key_len + 1);
+   px_token_stats->ui_token_len = ui_key_len;
+   px_token_stats->ui64_num_occurances = ui64_count;
+
+   (void) pal_memset (&x_node_data, 0x00, sizeof(x_node_data));
+   x_node_data.e_hm_key_type = eHM_KEY_TYPE_STRING;
+   x_node_data.u_hm_key.puc_str_key = (uint8_t *) px_token_stats->pc_token;
+   x_node_data.p_data = px_token_stats;
+   x_node_data.ui_data_size = sizeof(*px_token_stats);
+   e_hm_ret = hm_add_node (px_tok_ctxt->hl_token_hm, &x_node_data);
+   if (eHM_RET_SUCCESS != e_hm_ret)
+   {
+      pal_free (px_token_stats->pc_token);
+      pal_free (px_token_stats);
+      e_tok_ret = eTOKENIZER_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+   px_tok_ctxt->x_stats.ui_num_unique_tokens++;
+   e_tok_ret = eTOKENIZER_RET_SUCCESS;
+LBL_CLEANUP:
+   return e_tok_ret;
+}
+
+/*
+ * Adds the count of the entry to the hashmap. The entry stays in the cache
+ * with its score and counts on from 0.
+ */
+static TOKENIZER_RET_E hot_cache_write_back (
+   TOKENIZER_CTXT_X *px_tok_ctxt,
+   HOT_CACHE_ENTRY_X *px_entry)
+{
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_SUCCESS;
+   char ca_token[HOT_CACHE_MAX_TOKEN_LEN + 1] = {0};
+   uint32_t ui_i = 0;
+
+   if (0 == px_entry->ui_count)
+   {
+      goto LBL_CLEANUP;
+   }
+
+   for (ui_i = 0; ui_i < px_entry->us_token_len; ui_i++)
+   {
+      ca_token[ui_i] = (char) (px_entry->ui64_key >> (8 * ui_i));
+   }
+   ca_token[px_entry->us_token_len] = '\0';
+
+   e_tok_ret = update_token_stats (px_tok_ctxt, ca_token,
+      px_entry->us_token_len, px_entry->ui_count);
+   if (eTOKENIZER_RET_SUCCESS == e_tok_ret)
+   {
+      px_entry->ui_count = 0;
+   }
+LBL_CLEANUP:
+   return e_tok_ret;
+}
+
+static TOKENIZER_RET_E hot_cache_evict (
+   TOKENIZER_CTXT_X *px_tok_ctxt,
+   HOT_CACHE_ENTRY_X *px_entry)
+{
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_SUCCESS;
+
+   e_tok_ret = hot_cache_write_back (px_tok_ctxt, px_entry);
+
+   (void) pal_memset (px_entry, 0x00, sizeof(*px_entry));
+   return e_tok_ret;
+}
+
+/*
+ * Brings the hashmap up to date with the counts in the hot cache. The entries
+ * are not evicted, so that tokenizer_get_stats and tokenizer_for_each_token in
+ * the middle of a run, e.g. for a checkpoint, do not leave the cache cold.
+ */
+static TOKENIZER_RET_E hot_cache_flush (
+   TOKENIZER_CTXT_X *px_tok_ctxt)
+{
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_SUCCESS;
+   uint32_t ui_i = 0;
+
+   for (ui_i = 0; ui_i < px_tok_ctxt->ui_hot_cache_size; ui_i++)
+   {
+      e_tok_ret = hot_cache_write_back (px_tok_ctxt,
+         &(px_tok_ctxt->px_hot_cache[ui_i]));
+      if (eTOKENIZER_RET_SUCCESS != e_tok_ret)
+      {
+         break;
+      }
+   }
+   return e_tok_ret;
+}
+
+static TOKENIZER_RET_E count_token (
+   TOKENIZER_CTXT_X *px_tok_ctxt,
+   const char *pc_token,
+   uint32_t ui_token_len)
+{
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_FAILURE;
+   HOT_CACHE_ENTRY_X *px_entry = NULL;
+   uint64_t ui64_key = 0;
+   uint32_t ui_index = 0;
+   uint32_t ui_i = 0;
+   char *pc_key = NULL;
+
+   if ((0 == px_tok_ctxt->ui_hot_cache_size)
+      || (ui_token_len > HOT_CACHE_MAX_TOKEN_LEN))
+   {
+      goto LBL_UPDATE_HM;
+   }
+
+   /*
+    * The key is folded to lower case straight from the input.
+    */
+   for (ui_i = 0; ui_i < ui_token_len; ui_i++)
+   {
+      ui64_key |= ((uint64_t) (uint8_t) tolower (
+         (unsigned char) pc_token[ui_i])) << (8 * ui_i);
+   }
+   ui_index = ((uint32_t) ((ui64_key * 0x9E3779B97F4A7C15ULL) >> 32)) &
+      px_tok_ctxt->ui_hot_cache_mask;
+   px_entry = &(px_tok_ctxt->px_hot_cache[ui_index]);
+
+   px_tok_ctxt->x_stats.ui64_hot_cache_lookups++;
+   if ((ui64_key == px_entry->ui64_key)
+      && (ui_token_len == px_entry->us_token_len))
+   {
+      px_tok_ctxt->x_stats.ui64_hot_cache_hits++;
+      if (UINT32_MAX == px_entry->ui_count)
+      {
+         e_tok_ret = hot_cache_write_back (px_tok_ctxt, px_entry);
+         if (eTOKENIZER_RET_SUCCESS != e_tok_ret)
+         {
+            goto LBL_CLEANUP;
+         }
+      }
+      px_entry->ui_count++;
+      if (px_entry->us_score < UINT16_MAX)
+      {
+         px_entry->us_score++;
+      }
+      e_tok_ret = eTOKENIZER_RET_SUCCESS;
+      goto LBL_CLEANUP;
+   }
+
+   if (px_entry->us_score > 0)
+   {
+      px_entry->us_score--;
+      goto LBL_UPDATE_HM;
+   }
+
+   /*
+    * Write back the current occupant and take over the slot. Either way a
+    * miss costs one hashmap update, the same as without the cache.
+    */
+   e_tok_ret = hot_cache_evict (px_tok_ctxt, px_entry);
+   px_entry->ui64_key = ui64_key;
+   px_entry->us_token_len = (uint16_t) ui_token_len;
+   px_entry->ui_count = 1;
+   goto LBL_CLEANUP;
+
+LBL_UPDATE_HM:
+   pc_key = tokenizer_make_key (px_tok_ctxt, pc_token, ui_token_len);
+   if (NULL == pc_key)
+   {
+      e_tok_ret = eTOKENIZER_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+   e_tok_ret = update_token_stats (px_tok_ctxt, pc_key, ui_token_len, 1);
+LBL_CLEANUP:
+   return e_tok_ret;
+}
+
+/*
+ * Hands out the token pc_buf[ui_token_start, ui_token_start + ui_token_len),
+ * prefixed by whatever was carried over from the previous buffer.
+ */
+static TOKENIZER_RET_E emit_token (
+   TOKENIZER_CTXT_X *px_tok_ctxt,
+   const char *pc_buf,
+   uint32_t ui_token_start,
+   uint32_t ui_token_len,
+   bool b_strip_quotes)
+{
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_SUCCESS;
+   const char *pc_token = NULL;
+
+   pc_token = pc_buf + ui_token_start;
+   if (px_tok_ctxt->ui_carry_len > 0)
+   {
+      if (false == tokenizer_grow_buf (&(px_tok_ctxt->pc_carry),
+            &(px_tok_ctxt->ui_carry_size),
+            px_tok_ctxt->ui_carry_len + ui_token_len,
+            px_tok_ctxt->ui_carry_len))
+      {
+         px_tok_ctxt->ui_carry_len = 0;
+         e_tok_ret = eTOKENIZER_RET_RESOURCE_FAILURE;
+         goto LBL_CLEANUP;
+      }
+      (void) pal_memmove (px_tok_ctxt->pc_carry + px_tok_ctxt->ui_carry_len,
+         pc_token, ui_token_len);
+      pc_token = px_tok_ctxt->pc_carry;
+      ui_token_len += px_tok_ctxt->ui_carry_len;
+      px_tok_ctxt->ui_carry_len = 0;
+   }
+
+   if ((true == b_strip_quotes) && (ui_token_len >= 2)
+      && ('\'' == pc_token[0]) && ('\'' == pc_token[ui_token_len - 1]))
+   {
+      pc_token++;
+      ui_token_len -= 2;
+   }
+
+   if (0 == ui_token_len)
+   {
+      goto LBL_CLEANUP;
+   }
+
+   px_tok_ctxt->x_stats.ui64_num_tokens++;
+
+   if (NULL != px_tok_ctxt->x_init_params.fn_token_cbk)
+   {
+      px_tok_ctxt->x_init_params.fn_token_cbk (pc_token, ui_token_len,
+         px_tok_ctxt->x_init_params.p_app_data);
+   }
+
+   if (false == px_tok_ctxt->x_init_params.b_no_count)
+   {
+      e_tok_ret = count_token (px_tok_ctxt, pc_token, ui_token_len);
+   }
+LBL_CLEANUP:
+   return e_tok_ret;
+}
+
+/*
+ * Appends pc_buf[ui_token_start, ui_token_start + ui_token_len), followed by a
+ * '.' if b_add_dot is set, to the token in pc_carry.
+ */
+static TOKENIZER_RET_E carry_token (
+   TOKENIZER_CTXT_X *px_tok_ctxt,
+   const char *pc_buf,
+   uint32_t ui_token_start,
+   uint32_t ui_token_len,
+   bool b_add_dot)
+{
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_SUCCESS;
+   uint32_t ui_add_len = 0;
+
+   ui_add_len = (true == b_add_dot) ? (ui_token_len + 1) : ui_token_len;
+   if (false == tokenizer_grow_buf (&(px_tok_ctxt->pc_carry),
+         &(px_tok_ctxt->ui_carry_size),
+         px_tok_ctxt->ui_carry_len + ui_add_len,
+         px_tok_ctxt->ui_carry_len))
+   {
+      px_tok_ctxt->ui_carry_len = 0;
+      px_tok_ctxt->b_pending_dot = false;
+      e_tok_ret = eTOKENIZER_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+   (void) pal_memmove (px_tok_ctxt->pc_carry + px_tok_ctxt->ui_carry_len,
+      pc_buf + ui_token_start, ui_token_len);
+   px_tok_ctxt->ui_carry_len += ui_token_len;
+   if (true == b_add_dot)
+   {
+      px_tok_ctxt->pc_carry[px_tok_ctxt->ui_carry_len++] = '.';
+   }
+LBL_CLEANUP:
+   return e_tok_ret;
+}
+
+static TOKENIZER_RET_E scan_buffer (
+   TOKENIZER_CTXT_X *px_tok_ctxt,
+   const char *pc_buf,
+   uint32_t ui_buf_len)
+{
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_SUCCESS;
+   uint32_t ui_i = 0;
+   uint32_t ui_token_start = 0;
+   uint32_t ui_token_len = 0;
+   char c = 0;
+   const char *pc_newline = NULL;
+
+   if (true == px_tok_ctxt->b_skip_line)
+   {
+      pc_newline = memchr (pc_buf, '\n', ui_buf_len);
+      if (NULL == pc_newline)
+      {
+         goto LBL_CLEANUP;
+      }
+      px_tok_ctxt->b_skip_line = false;
+      ui_i = (uint32_t) (pc_newline - pc_buf);
+   }
+
+   if (true == px_tok_ctxt->b_pending_dot)
+   {
+      if (0 == ui_buf_len)
+      {
+         goto LBL_CLEANUP;
+      }
+
+      px_tok_ctxt->b_pending_dot = false;
+      if (TOKENIZER_IS_DIGIT(pc_buf[0]))
+      {
+         e_tok_ret = carry_token (px_tok_ctxt, pc_buf, 0, 0, true);
+         px_tok_ctxt->b_numeric = false;
+      }
+      else
+      {
+         e_tok_ret = emit_token (px_tok_ctxt, pc_buf, 0, 0, false);
+      }
+      if (eTOKENIZER_RET_SUCCESS != e_tok_ret)
+      {
+         goto LBL_CLEANUP;
+      }
+   }
+
+   for (; ui_i < ui_buf_len; ui_i++)
+   {
+      c = pc_buf[ui_i];
+
+      switch (c)
+      {
+         case '\n':
+         {
+            if ((ui_token_len > 0) || (px_tok_ctxt->ui_carry_len > 0))
+            {
+               e_tok_ret = emit_token (px_tok_ctxt, pc_buf, ui_token_start,
+                  ui_token_len, true);
+               ui_token_len = 0;
+            }
+            px_tok_ctxt->b_ignore = false;
+            break;
+         }
+         case '\0':
+         {
+            /*
+             * The line based reader this replaced saw a NUL as the end of the
+             * line, so the rest of the line is skipped.
+             */
+            if ((ui_token_len > 0) || (px_tok_ctxt->ui_carry_len > 0))
+            {
+               e_tok_ret = emit_token (px_tok_ctxt, pc_buf, ui_token_start,
+                  ui_token_len, true);
+               ui_token_len = 0;
+            }
+            pc_newline = memchr (pc_buf + ui_i, '\n', ui_buf_len - ui_i);
+            if (NULL == pc_newline)
+            {
+               px_tok_ctxt->b_skip_line = true;
+               ui_i = ui_buf_len - 1;
+            }
+            else
+            {
+               /*
+                * The '\n' is handled by the next iteration.
+                */
+               ui_i = (uint32_t) (pc_newline - pc_buf) - 1;
+            }
+            break;
+         }
+         case '<':
+         case '>':
+         {
+            px_tok_ctxt->b_ignore = true;
+            break;
+         }
+         case '.':
+         {
+            if ((0 == ui_token_len) && (0 == px_tok_ctxt->ui_carry_len))
+            {
+               break;
+            }
+
+            /*
+             * Handle the following case:
+             *    1. 10.901
+             * While nothing is being ignored the token ends right before the
+             * '.', so the '.' can simply be taken into the span.
+             */
+            if (true == px_tok_ctxt->b_numeric)
+            {
+               if ((ui_i + 1) == ui_buf_len)
+               {
+                  px_tok_ctxt->b_pending_dot = true;
+                  break;
+               }
+               if (TOKENIZER_IS_DIGIT(pc_buf[ui_i + 1]))
+               {
+                  if (false == px_tok_ctxt->b_ignore)
+                  {
+                     if (0 == ui_token_len)
+                     {
+                        ui_token_start = ui_i;
+                     }
+                     ui_token_len++;
+                  }
+                  else
+                  {
+                     /*
+                      * After a '<' or '>' the digits following the '.' are
+                      * ignored but the '.' itself is still kept, e.g.
+                      * "12<x.5" gives "12.". The '.' is not next to the token
+                      * any more, so both go into pc_carry.
+                      */
+                     e_tok_ret = carry_token (px_tok_ctxt, pc_buf,
+                        ui_token_start, ui_token_len, true);
+                     ui_token_len = 0;
+                  }
+                  px_tok_ctxt->b_numeric = false;
+                  break;
+               }
+            }
+
+            e_tok_ret = emit_token (px_tok_ctxt, pc_buf, ui_token_start,
+               ui_token_len, false);
+            ui_token_len = 0;
+            break;
+         }
+         case ',':
+         case '!':
+         case ' ':
+         case '(':
+         case ')':
+         case '/':
+            /*
+             * All these are considered as delimiters.
+             */
+         {
+            if ((ui_token_len > 0) || (px_tok_ctxt->ui_carry_len > 0))
+            {
+               e_tok_ret = emit_token (px_tok_ctxt, pc_buf, ui_token_start,
+                  ui_token_len, true);
+               ui_token_len = 0;
+            }
+            break;
+         }
+         default:
+         {
+            if (true == px_tok_ctxt->b_ignore)
+            {
+               break;
+            }
+
+            if (0 == ui_token_len)
+            {
+               ui_token_start = ui_i;
+               if (0 == px_tok_ctxt->ui_carry_len)
+               {
+                  px_tok_ctxt->b_numeric = true;
+                  ui_token_len++;
+                  break;
+               }
+            }
+            if (!TOKENIZER_IS_DIGIT(c))
+            {
+               px_tok_ctxt->b_numeric = false;
+            }
+            ui_token_len++;
+            break;
+         }
+      }
+
+      if (eTOKENIZER_RET_SUCCESS != e_tok_ret)
+      {
+         goto LBL_CLEANUP;
+      }
+   }
+
+   /*
+    * Carry the token cut by the end of the buffer over to the next one. A
+    * pending '.' is not part of it until a digit follows.
+    */
+   if (ui_token_len > 0)
+   {
+      e_tok_ret = carry_token (px_tok_ctxt, pc_buf, ui_token_start,
+         ui_token_len, false);
+   }
+LBL_CLEANUP:
+   return e_tok_ret;
+}
+
+static HM_RET_E fn_hm_for_each_cbk (
+   HM_NODE_DATA_X *px_curr_node_data,
+   void *p_app_data)
+{
+   HM_RET_E e_hm_ret = eHM_RET_FAILURE;
+   TOKENIZER_FOR_EACH_CTXT_X *px_for_each_ctxt = NULL;
+   TOKEN_STATS_X *px_token_stats = NULL;
+
+   px_for_each_ctxt = (TOKENIZER_FOR_EACH_CTXT_X *) p_app_data;
+   px_token_stats = (TOKEN_STATS_X *) px_curr_node_data->p_data;
+
+   px_for_each_ctxt->e_cbk_ret = px_for_each_ctxt->fn_for_each_cbk (
+      px_token_stats->pc_token, px_token_stats->ui_token_len,
+      px_token_stats->ui64_num_occurances, px_for_each_ctxt->p_app_data);
+   if (eTOKENIZER_RET_SUCCESS == px_for_each_ctxt->e_cbk_ret)
+   {
+      e_hm_ret = eHM_RET_SUCCESS;
+   }
+   return e_hm_ret;
+}
+
+static HM_RET_E fn_hm_delete_cbk (
+   HM_NODE_DATA_X *px_curr_node_data,
+   void *p_app_data)
+{
+   TOKEN_STATS_X *px_token_stats = NULL;
+
+   (void) p_app_data;
+
+   px_token_stats = (TOKEN_STATS_X *) px_curr_node_data->p_data;
+   if (NULL != px_token_stats)
+   {
+      if (NULL != px_token_stats->pc_token)
+      {
+         pal_free (px_token_stats->pc_token);
+      }
+      pal_free (px_token_stats);
+   }
+   return eHM_RET_SUCCESS;
+}
+
+TOKENIZER_RET_E tokenizer_create (
+   TOKENIZER_HDL *phl_tokenizer_hdl,
+   TOKENIZER_INIT_PARAMS_X *px_init_params)
+{
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_FAILURE;
+   TOKENIZER_CTXT_X *px_tok_ctxt = NULL;
+   HM_RET_E e_hm_ret = eHM_RET_FAILURE;
+   HM_INIT_PARAMS_X x_hm_init_params = {0};
+   uint32_t ui_hot_cache_size = 0;
+
+   if ((NULL == phl_tokenizer_hdl) || (NULL == px_init_params))
+   {
+      e_tok_ret = eTOKENIZER_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   ui_hot_cache_size = px_init_params->ui_hot_cache_size;
+   if ((ui_hot_cache_size > TOKENIZER_MAX_HOT_CACHE_SIZE)
+      || (0 != (ui_hot_cache_size & (ui_hot_cache_size - 1))))
+   {
+      e_tok_ret = eTOKENIZER_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   px_tok_ctxt = pal_malloc (sizeof(TOKENIZER_CTXT_X), NULL);
+   if (NULL == px_tok_ctxt)
+   {
+      e_tok_ret = eTOKENIZER_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+   (void) pal_memset (px_tok_ctxt, 0x00, sizeof(*px_tok_ctxt));
+   (void) pal_memmove (&(px_tok_ctxt->x_init_params), px_init_params,
+      sizeof(px_tok_ctxt->x_init_params));
+
+   x_hm_init_params.e_hm_key_type = eHM_KEY_TYPE_STRING;
+   x_hm_init_params.ui_hm_table_size = (0 == px_init_params->ui_hm_table_size) ?
+      TOKENIZER_DEFAULT_HM_TABLE_SIZE : px_init_params->ui_hm_table_size;
+   e_hm_ret = hm_create (&(px_tok_ctxt->hl_token_hm), &x_hm_init_params);
+   if (eHM_RET_SUCCESS != e_hm_ret)
+   {
+      e_tok_ret = eTOKENIZER_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+
+   if (ui_hot_cache_size > 0)
+   {
+      px_tok_ctxt->px_hot_cache = pal_malloc (
+         ui_hot_cache_size * sizeof(HOT_CACHE_ENTRY_X), NULL);
+      if (NULL == px_tok_ctxt->px_hot_cache)
+      {
+         e_tok_ret = eTOKENIZER_RET_RESOURCE_FAILURE;
+         goto LBL_CLEANUP;
+      }
+      (void) pal_memset (px_tok_ctxt->px_hot_cache, 0x00,
+         ui_hot_cache_size * sizeof(HOT_CACHE_ENTRY_X));
+      px_tok_ctxt->ui_hot_cache_size = ui_hot_cache_size;
+      px_tok_ctxt->ui_hot_cache_mask = ui_hot_cache_size - 1;
+   }
+
+   *phl_tokenizer_hdl = (TOKENIZER_HDL) px_tok_ctxt;
+   e_tok_ret = eTOKENIZER_RET_SUCCESS;
+LBL_CLEANUP:
+   if ((eTOKENIZER_RET_SUCCESS != e_tok_ret) && (NULL != px_tok_ctxt))
+   {
+      (void) tokenizer_delete ((TOKENIZER_HDL) px_tok_ctxt);
+   }
+   return e_tok_ret;
+}
+
+TOKENIZER_RET_E tokenizer_feed (
+   TOKENIZER_HDL hl_tokenizer_hdl,
+   const char *pc_buf,
+   uint32_t ui_buf_len)
+{
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_FAILURE;
+   TOKENIZER_CTXT_X *px_tok_ctxt = NULL;
+
+   if ((NULL == hl_tokenizer_hdl) || ((NULL == pc_buf) && (ui_buf_len > 0)))
+   {
+      e_tok_ret = eTOKENIZER_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   px_tok_ctxt = (TOKENIZER_CTXT_X *) hl_tokenizer_hdl;
+   e_tok_ret = scan_buffer (px_tok_ctxt, pc_buf, ui_buf_len);
+LBL_CLEANUP:
+   return e_tok_ret;
+}
+
+TOKENIZER_RET_E tokenizer_finish (
+   TOKENIZER_HDL hl_tokenizer_hdl)
+{
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_FAILURE;
+   TOKENIZER_CTXT_X *px_tok_ctxt = NULL;
+   bool b_pending_dot = false;
+
+   if (NULL == hl_tokenizer_hdl)
+   {
+      e_tok_ret = eTOKENIZER_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   px_tok_ctxt = (TOKENIZER_CTXT_X *) hl_tokenizer_hdl;
+   b_pending_dot = px_tok_ctxt->b_pending_dot;
+   px_tok_ctxt->b_pending_dot = false;
+   px_tok_ctxt->b_ignore = false;
+   px_tok_ctxt->b_skip_line = false;
+
+   e_tok_ret = eTOKENIZER_RET_SUCCESS;
+   if (px_tok_ctxt->ui_carry_len > 0)
+   {
+      /*
+       * Same as the end of a line, except after a '.' where the token has
+       * already been ended by the '.'.
+       */
+      e_tok_ret = emit_token (px_tok_ctxt, px_tok_ctxt->pc_carry, 0, 0,
+         !b_pending_dot);
+   }
+LBL_CLEANUP:
+   return e_tok_ret;
+}
+
+TOKENIZER_RET_E tokenizer_for_each_token (
+   TOKENIZER_HDL hl_tokenizer_hdl,
+   pfn_tokenizer_for_each_cbk fn_for_each_cbk,
+   void *p_app_data)
+{
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_FAILURE;
+   TOKENIZER_CTXT_X *px_tok_ctxt = NULL;
+   TOKENIZER_FOR_EACH_CTXT_X x_for_each_ctxt = {NULL};
+   HM_RET_E e_hm_ret = eHM_RET_FAILURE;
+
+   if ((NULL == hl_tokenizer_hdl) || (NULL == fn_for_each_cbk))
+   {
+      e_tok_ret = eTOKENIZER_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   px_tok_ctxt = (TOKENIZER_CTXT_X *) hl_tokenizer_hdl;
+   e_tok_ret = hot_cache_flush (px_tok_ctxt);
+   if (eTOKENIZER_RET_SUCCESS != e_tok_ret)
+   {
+      goto LBL_CLEANUP;
+   }
+
+   x_for_each_ctxt.fn_for_each_cbk = fn_for_each_cbk;
+   x_for_each_ctxt.p_app_data = p_app_data;
+   x_for_each_ctxt.e_cbk_ret = eTOKENIZER_RET_SUCCESS;
+   e_hm_ret = hm_for_each (px_tok_ctxt->hl_token_hm, fn_hm_for_each_cbk,
+      &x_for_each_ctxt);
+   if (eTOKENIZER_RET_SUCCESS != x_for_each_ctxt.e_cbk_ret)
+   {
+      e_tok_ret = x_for_each_ctxt.e_cbk_ret;
+   }
+   else if (eHM_RET_SUCCESS != e_hm_ret)
+   {
+      e_tok_ret = eTOKENIZER_RET_FAILURE;
+   }
+   else
+   {
+      e_tok_ret = eTOKENIZER_RET_SUCCESS;
+   }
+LBL_CLEANUP:
+   return e_tok_ret;
+}
+
+TOKENIZER_RET_E tokenizer_add_token (
+   TOKENIZER_HDL hl_tokenizer_hdl,
+   const char *pc_token,
+   uint32_t ui_token_len,
+   uint64_t ui64_count)
+{
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_FAILURE;
+   TOKENIZER_CTXT_X *px_tok_ctxt = NULL;
+   char *pc_key = NULL;
+
+   if ((NULL == hl_tokenizer_hdl) || (NULL == pc_token) || (0 == ui_token_len)
+      || (0 == ui64_count))
+   {
+      e_tok_ret = eTOKENIZER_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   px_tok_ctxt = (TOKENIZER_CTXT_X *) hl_tokenizer_hdl;
+   pc_key = tokenizer_make_key (px_tok_ctxt, pc_token, ui_token_len);
+   if (NULL == pc_key)
+   {
+      e_tok_ret = eTOKENIZER_RET_RESOURCE_FAILURE;
+      goto LBL_CLEANUP;
+   }
+
+   e_tok_ret = update_token_stats (px_tok_ctxt, pc_key, ui_token_len,
+      ui64_count);
+   if (eTOKENIZER_RET_SUCCESS == e_tok_ret)
+   {
+      px_tok_ctxt->x_stats.ui64_num_tokens += ui64_count;
+   }
+LBL_CLEANUP:
+   return e_tok_ret;
+}
+
+TOKENIZER_RET_E tokenizer_get_stats (
+   TOKENIZER_HDL hl_tokenizer_hdl,
+   TOKENIZER_STATS_X *px_stats)
+{
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_FAILURE;
+   TOKENIZER_CTXT_X *px_tok_ctxt = NULL;
+
+   if ((NULL == hl_tokenizer_hdl) || (NULL == px_stats))
+   {
+      e_tok_ret = eTOKENIZER_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   /*
+    * Tokens still in the hot cache may not be in the hashmap yet and would
+    * be missing from the unique count.
+    */
+   px_tok_ctxt = (TOKENIZER_CTXT_X *) hl_tokenizer_hdl;
+   e_tok_ret = hot_cache_flush (px_tok_ctxt);
+   if (eTOKENIZER_RET_SUCCESS != e_tok_ret)
+   {
+      goto LBL_CLEANUP;
+   }
+
+   (void) pal_memmove (px_stats, &(px_tok_ctxt->x_stats), sizeof(*px_stats));
+LBL_CLEANUP:
+   return e_tok_ret;
+}
+
+TOKENIZER_RET_E tokenizer_delete (
+   TOKENIZER_HDL hl_tokenizer_hdl)
+{
+   TOKENIZER_RET_E e_tok_ret = eTOKENIZER_RET_FAILURE;
+   TOKENIZER_CTXT_X *px_tok_ctxt = NULL;
+
+   if (NULL == hl_tokenizer_hdl)
+   {
+      e_tok_ret = eTOKENIZER_RET_INVALID_ARGS;
+      goto LBL_CLEANUP;
+   }
+
+   px_tok_ctxt = (TOKENIZER_CTXT_X *) hl_tokenizer_hdl;
+   if (NULL != px_tok_ctxt->hl_token_hm)
+   {
+      (void) hm_for_each (px_tok_ctxt->hl_token_hm, fn_hm_delete_cbk, NULL);
+      (void) hm_delete (px_tok_ctxt->hl_token_hm);
+   }
+   if (NULL != px_tok_ctxt->px_hot_cache)
+   {
+      pal_free (px_tok_ctxt->px_hot_cache);
+   }
+   if (NULL != px_tok_ctxt->pc_carry)
+   {
+      pal_free (px_tok_ctxt->pc_carry);
+   }
+   if (NULL != px_tok_ctxt->pc_key)
+   {
+      pal_free (px_tok_ctxt->pc_key);
+   }
+   pal_free (px_tok_ctxt);
+   e_tok_ret = eTOKENIZER_RET_SUCCESS;
+LBL_CLEANUP:
+   return e_tok_ret;
+}